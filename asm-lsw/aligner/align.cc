@@ -21,6 +21,7 @@
 #include <asm_lsw/vector_source.hh>
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <dispatch/dispatch.h>
+#include <sdsl/suffix_array_algorithm.hpp>
 #include <thread>
 #include "aligner.hh"
 
@@ -35,11 +36,13 @@ public:
 };
 
 
-template <bool t_report_all>
+template <cst_backend t_backend, bool t_report_all>
 class align_context_tpl : public align_context
 {
 protected:
 	typedef ios::stream <ios::file_descriptor_source> source_stream_type;
+	typedef typename cst_backend_types <t_backend>::cst_type cst_type;
+	typedef typename cst_backend_types <t_backend>::kn_matcher_type kn_matcher_type;
 
 protected:
 	cst_type									m_cst{};
@@ -48,9 +51,17 @@ protected:
 	std::mutex									m_cout_mutex{};
 	dispatch_queue_t							m_loading_queue;
 	dispatch_queue_t							m_aligning_queue;
+	dispatch_queue_t							m_matcher_queue;
 	asm_lsw::vector_source						m_vs;
+	index_header								m_header;
 	unsigned short								m_k;
 	reporting_style								m_reporting_style;
+	bool										m_single_thread;
+	bool										m_verify_index;
+	bool										m_dna;
+	asm_lsw::dna_n_policy						m_n_policy;
+	asm_lsw::huge_page_policy					m_huge_page_policy;
+	asm_lsw::numa_policy						m_numa_policy;
 	
 protected:
 	static int open_file(char const *fname)
@@ -62,30 +73,167 @@ protected:
 	}
 
 	void cleanup() { delete this; }
+	
+	static void index_error(std::string const &error)
+	{
+		std::cerr << "Error: unable to load the index: " << error << '.' << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	
+	// Check the type and optionally the checksum of the section, then seek to its beginning.
+	void prepare_section(std::istream &stream, index_section const section, uint64_t const type_id) const
+	{
+		std::string error;
+		if (!m_header.check_type(section, type_id, error))
+			index_error(error);
+		
+		auto const &entry(m_header.section(section));
+		if (m_verify_index && !m_header.verify_checksum(stream, entry))
+			index_error("checksum mismatch");
+		
+		stream.seekg(entry.offset);
+	}
+	
+	// Try to handle the read with the CST only, i.e. with backward search. Return false if
+	// the read needs to be passed to the matcher.
+	template <typename t_pattern>
+	bool find_exact(t_pattern const &pattern, typename kn_matcher_type::csa_ranges &ranges) const
+	{
+		typename cst_type::size_type lb(0), rb(0);
+		auto const count(sdsl::backward_search(m_cst.csa, 0, m_cst.csa.size() - 1, pattern.cbegin(), pattern.cend(), lb, rb));
+		if (count)
+			ranges.emplace_back(lb, rb);
+		
+		// An exact match is enough if the first match is requested.
+		return (0 == m_k || (count && !t_report_all));
+	}
+	
+	// Call fn with the read as a pattern, i.e. as a dna_pattern with --dna.
+	template <typename t_fn>
+	void visit_pattern(std::vector <char> const &seq, t_fn &&fn) const
+	{
+		if (m_dna)
+			fn(asm_lsw::dna_pattern(seq));
+		else
+			fn(seq);
+	}
+	
+	// Report the exact matches if they suffice, otherwise pass the read to m_matcher_queue.
+	void find_approximate(std::string const &identifier, std::unique_ptr <std::vector <char>> &seq, bool const try_exact)
+	{
+		if (try_exact)
+		{
+			typename kn_matcher_type::csa_ranges ranges;
+			bool found(false);
+			visit_pattern(*seq, [this, &ranges, &found](auto const &pattern){
+				found = this->find_exact(pattern, ranges);
+			});
+			
+			if (found)
+			{
+				m_vs.put_vector(seq);
+				report(identifier, ranges);
+				return;
+			}
+		}
+		
+		auto *seq_ptr(seq.release());
+		auto find_approximate_fn = [this, identifier, seq_ptr](){
+			std::unique_ptr <std::vector <char>> seq(seq_ptr);
+			
+			typename kn_matcher_type::csa_ranges ranges;
+			visit_pattern(*seq, [this, &ranges](auto const &pattern){
+				m_matcher.template find_approximate <t_report_all>(pattern, m_k, ranges);
+			});
+			m_vs.put_vector(seq);
+			report(identifier, ranges);
+		};
+		
+		asm_lsw::dispatch_async_fn(m_matcher_queue, std::move(find_approximate_fn));
+	}
+	
+	void report(std::string const &identifier, typename kn_matcher_type::csa_ranges &ranges)
+	{
+		asm_lsw::util::post_process_ranges(ranges);
+		
+		std::stringstream output;
+		output << "Sequence identifier: " << identifier << "\n";
+		
+		switch (m_reporting_style)
+		{
+			case reporting_style::csa_ranges:
+			{
+				output << "Ranges:" << '\n';
+				for (auto const &k : ranges)
+					output << "\t(" << +k.first << ", " << +k.second << ")\n";
+				
+				break;
+			}
+				
+			case reporting_style::text_positions:
+			{
+				auto const &isa(m_cst.csa.isa);
+				
+				output << "Text positions:" << '\n';
+				for (auto const &k : ranges)
+				{
+					for (typename cst_type::csa_type::size_type i(k.first); i <= k.second; ++i)
+						output << '\t' << +isa[i] << '\n';
+				}
+				
+				break;
+			}
+				
+			default:
+				assert(0);
+				break;
+		}
+		
+		std::lock_guard <std::mutex> guard(m_cout_mutex);
+		std::cout << output.str();
+		std::cout.flush();
+	}
 
 public:
 	// hardware_concurrency could be a good hint for the number or required buffers.
 	align_context_tpl(
 		dispatch_queue_t loading_queue,
 		dispatch_queue_t aligning_queue,
+		dispatch_queue_t matcher_queue,
+		index_header const &header,
 		unsigned short const k,
 		reporting_style const rs,
-		bool single_thread
+		bool single_thread,
+		bool const verify_index,
+		bool const dna,
+		asm_lsw::dna_n_policy const n_policy,
+		asm_lsw::huge_page_policy const hp,
+		asm_lsw::numa_policy const np
 	):
 		m_loading_queue(loading_queue),
 		m_aligning_queue(aligning_queue),
+		m_matcher_queue(matcher_queue),
 		m_vs(single_thread ? 1 : std::thread::hardware_concurrency(), true),
+		m_header(header),
 		m_k(k),
-		m_reporting_style(rs)
+		m_reporting_style(rs),
+		m_single_thread(single_thread),
+		m_verify_index(verify_index),
+		m_dna(dna),
+		m_n_policy(n_policy),
+		m_huge_page_policy(hp),
+		m_numa_policy(np)
 	{
 		dispatch_retain(m_loading_queue);
 		dispatch_retain(m_aligning_queue);
+		dispatch_retain(m_matcher_queue);
 	}
 	
 	~align_context_tpl()
 	{
 		dispatch_release(m_loading_queue);
 		dispatch_release(m_aligning_queue);
+		dispatch_release(m_matcher_queue);
 	}
 	
 	virtual void load_and_align(char const *source_fname_c, char const *cst_fname_c) override
@@ -98,21 +246,81 @@ public:
 			source_fname = std::string(source_fname_c);
 		
 		auto load_ds_fn = [this, cst_fname = std::move(cst_fname)](){
-			int const fd(open_file(cst_fname.c_str()));
-			source_stream_type ds_stream(fd, ios::close_handle);
+			// Place the loaded data structures according to the policy. The loading threads
+			// are created afterwards and inherit the NUMA policy.
+			asm_lsw::memory_policy_scope policy_scope(m_huge_page_policy, m_numa_policy);
+			if (asm_lsw::huge_page_policy::none != m_huge_page_policy && !policy_scope.huge_pages_enabled())
+				std::cerr << "Warning: unable to use huge pages." << std::endl;
+			if (asm_lsw::numa_policy::none != m_numa_policy && !policy_scope.numa_policy_set())
+				std::cerr << "Warning: unable to set the NUMA policy." << std::endl;
+			
+			// Each section has its own stream so that the CST and the matcher components
+			// may be loaded concurrently.
+			auto const open_section([this, &cst_fname](index_section const section, uint64_t const type_id){
+				std::unique_ptr <std::istream> stream(new source_stream_type(open_file(cst_fname.c_str()), ios::close_handle));
+				prepare_section(*stream, section, type_id);
+				return stream;
+			});
+			
+			// Load the CST. Reads that can be handled with the CST only may be aligned
+			// as soon as it has been loaded.
+			std::cerr << "Loading the index…" << std::endl;
+			assert(t_backend == m_header.backend());
+			auto const load_cst_fn([this, &open_section](){
+				try
+				{
+					auto stream(open_section(index_section::cst, index_type_id(m_cst)));
+					m_cst.load(*stream);
+				}
+				catch (std::exception const &exc)
+				{
+					index_error(exc.what());
+				}
+				catch (...)
+				{
+					index_error("unknown error");
+				}
+				
+				if (!m_single_thread)
+				{
+					std::cerr << "CST loaded." << std::endl;
+					dispatch_resume(m_aligning_queue);
+				}
+			});
 			
-			// Load the CST.
-			std::cerr << "Loading the CST…" << std::endl;
-			m_cst.load(ds_stream);
+			std::thread cst_thread;
+			if (m_single_thread)
+				load_cst_fn();
+			else
+				cst_thread = std::thread(load_cst_fn);
 			
-			// Load the other data structures.
-			std::cerr << "Loading other data structures…" << std::endl;
+			// Load the other data structures. The matcher only stores a pointer to the CST
+			// so it may be created before the CST has been loaded.
+			typedef typename kn_matcher_type::k1_matcher_type k1_matcher_type;
 			kn_matcher_type tmp_matcher(m_cst, false);
-			tmp_matcher.load(ds_stream);
+			std::string const matcher_name(sdsl::util::class_name(tmp_matcher));
+			tmp_matcher.load_components(
+				[&open_section, &matcher_name](typename k1_matcher_type::component const c){
+					auto const type_id(index_type_id(matcher_name + "/" + k1_matcher_type::component_name(c)));
+					return open_section(matcher_section(c), type_id);
+				},
+				(m_single_thread ? 1 : 0)
+			);
+			
+			if (cst_thread.joinable())
+				cst_thread.join();
+			
 			m_matcher = std::move(tmp_matcher);
 			
+			// SDSL allocates the loaded data structures with malloc.
+			policy_scope.advise_loaded_memory(m_cst);
+			policy_scope.advise_loaded_memory(m_matcher);
+			
 			std::cerr << "Loading complete." << std::endl;
 			loading_complete();
+			
+			if (!m_single_thread)
+				dispatch_resume(m_matcher_queue);
 		};
 		
 		auto read_sequences_fn = [this, source_fname_c, source_fname = std::move(source_fname)](){
@@ -126,10 +334,23 @@ public:
 			}
 		};
 		
-		asm_lsw::dispatch_async_fn(m_loading_queue, std::move(read_sequences_fn));
-		
-		// Prevent aligning blocks from being executed before CST has been read.
-		asm_lsw::dispatch_barrier_async_fn(m_aligning_queue, std::move(load_ds_fn));
+		if (m_single_thread)
+		{
+			// All the queues are the same serial queue, so just prevent aligning blocks from
+			// being executed before the index has been read.
+			asm_lsw::dispatch_async_fn(m_loading_queue, std::move(read_sequences_fn));
+			asm_lsw::dispatch_barrier_async_fn(m_aligning_queue, std::move(load_ds_fn));
+		}
+		else
+		{
+			// Blocks that need only the CST are executed in m_aligning_queue and those that need
+			// the matcher in m_matcher_queue. Keep the queues suspended until the respective
+			// data structures have been loaded.
+			dispatch_suspend(m_aligning_queue);
+			dispatch_suspend(m_matcher_queue);
+			asm_lsw::dispatch_async_fn(m_loading_queue, std::move(read_sequences_fn));
+			asm_lsw::dispatch_async_fn(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), std::move(load_ds_fn));
+		}
 	}
 	
 	// Reader callbacks.
@@ -142,55 +363,31 @@ public:
 		assert(&vs == &m_vs);
 		auto *seq_ptr(seq.release());
 		
-		auto find_approximate_fn = [this, identifier, seq_ptr](){
+		auto find_exact_fn = [this, identifier, seq_ptr](){
 			std::unique_ptr <std::vector <char>> seq(seq_ptr);
 			
-			kn_matcher_type::csa_ranges ranges;
-			m_matcher.find_approximate <t_report_all>(*seq, m_k, ranges);
-			m_vs.put_vector(seq);
-			
-			asm_lsw::util::post_process_ranges(ranges);
-			
-			std::stringstream output;
-			output << "Sequence identifier: " << identifier << "\n";
-			
-			switch (m_reporting_style)
+			bool try_exact(true);
+			if (m_dna)
 			{
-				case reporting_style::csa_ranges:
-				{
-					output << "Ranges:" << '\n';
-					for (auto const &k : ranges)
-						output << "\t(" << +k.first << ", " << +k.second << ")\n";
-					
-					break;
-				}
-					
-				case reporting_style::text_positions:
+				// Each N costs one difference, so reads with more than k of them cannot match.
+				auto const n_count(asm_lsw::dna_alphabet::normalize(*seq));
+				if (n_count && (asm_lsw::dna_n_policy::reject == m_n_policy || m_k < n_count))
 				{
-					auto const &isa(m_cst.csa.isa);
-					
-					output << "Text positions:" << '\n';
-					for (auto const &k : ranges)
-					{
-						for (cst_type::csa_type::size_type i(k.first); i <= k.second; ++i)
-							output << '\t' << +isa[i] << '\n';
-					}
-					
-					break;
+					m_vs.put_vector(seq);
+					typename kn_matcher_type::csa_ranges ranges;
+					report(identifier, ranges);
+					return;
 				}
-					
-				default:
-					assert(0);
-					break;
+				
+				// N does not occur in the text, so the read cannot match exactly.
+				try_exact = (0 == n_count);
 			}
 			
-			std::lock_guard <std::mutex> guard(m_cout_mutex);
-			std::cout << output.str();
-			std::cout.flush();
+			find_approximate(identifier, seq, try_exact);
 		};
 		
 		//std::cerr << "Dispatching align block" << std::endl;
-		asm_lsw::dispatch_async_fn(m_aligning_queue, find_approximate_fn);
+		asm_lsw::dispatch_async_fn(m_aligning_queue, std::move(find_exact_fn));
 	}
 	
 	void finish()
@@ -207,19 +404,40 @@ public:
 			exit(EXIT_SUCCESS);
 		};
 		
+		// The blocks in m_matcher_queue are dispatched from m_aligning_queue, so wait for the
+		// latter first.
+		auto finish_fn = [this, exit_fn](){
+			asm_lsw::dispatch_barrier_async_fn(m_matcher_queue, exit_fn);
+		};
+		
 		//std::cerr << "Dispatching finish block" << std::endl;
-		asm_lsw::dispatch_barrier_async_fn(m_aligning_queue, std::move(exit_fn));
+		asm_lsw::dispatch_barrier_async_fn(m_aligning_queue, std::move(finish_fn));
 	}
 };
 
 
+template <cst_backend t_backend, typename ... t_args>
+align_context *new_align_context(bool const report_all, t_args && ... args)
+{
+	if (report_all)
+		return new align_context_tpl <t_backend, true>(std::forward <t_args>(args)...);
+	else
+		return new align_context_tpl <t_backend, false>(std::forward <t_args>(args)...);
+}
+
+
 void align(
 	char const *source_fname,
 	char const *cst_fname,
 	short const k,
 	reporting_style const rs,
 	bool const report_all,
-	bool const single_thread
+	bool const single_thread,
+	bool const verify_index,
+	bool const dna,
+	asm_lsw::dna_n_policy const n_policy,
+	asm_lsw::huge_page_policy const hp,
+	asm_lsw::numa_policy const np
 )
 {
 	// dispatch_main calls pthread_exit, so the supporting data structures need to be
@@ -229,19 +447,52 @@ void align(
 	
 	dispatch_queue_t loading_queue(dispatch_get_main_queue());
 	dispatch_queue_t aligning_queue(loading_queue);
+	dispatch_queue_t matcher_queue(loading_queue);
 	if (!single_thread)
+	{
 		aligning_queue = dispatch_queue_create("fi.iki.tsnorri.asm_lsw_aligning_queue", DISPATCH_QUEUE_CONCURRENT);
+		matcher_queue = dispatch_queue_create("fi.iki.tsnorri.asm_lsw_matcher_queue", DISPATCH_QUEUE_CONCURRENT);
+	}
+	
+	// Read the header to reject incompatible indices before loading and to choose the CST type.
+	index_header header;
+	{
+		int const fd(open(cst_fname, O_RDONLY | O_SHLOCK));
+		if (-1 == fd)
+			handle_error();
+		ios::stream <ios::file_descriptor_source> ds_stream(fd, ios::close_handle);
+		
+		std::string error;
+		if (!header.read(ds_stream, error))
+		{
+			std::cerr << "Error: unable to load the index: " << error << '.' << std::endl;
+			exit(EXIT_FAILURE);
+		}
+	}
 	
 	// align_context(_tpl) is deallocated by itself by calling cleanup() (in finish()).
 	align_context *ctx(nullptr);
 	
-	if (report_all)
-		ctx = new align_context_tpl <true>(loading_queue, aligning_queue, k, rs, single_thread);
-	else
-		ctx = new align_context_tpl <false>(loading_queue, aligning_queue, k, rs, single_thread);
+	switch (header.backend())
+	{
+		case cst_backend::compact:
+			ctx = new_align_context <cst_backend::compact>(report_all, loading_queue, aligning_queue, matcher_queue, header, k, rs, single_thread, verify_index, dna, n_policy, hp, np);
+			break;
+			
+		case cst_backend::fast:
+			ctx = new_align_context <cst_backend::fast>(report_all, loading_queue, aligning_queue, matcher_queue, header, k, rs, single_thread, verify_index, dna, n_policy, hp, np);
+			break;
+			
+		default:
+			assert(0);
+			break;
+	}
 	
 	if (!single_thread)
+	{
 		dispatch_release(aligning_queue);
+		dispatch_release(matcher_queue);
+	}
 	
 	ctx->load_and_align(source_fname, cst_fname);
 	
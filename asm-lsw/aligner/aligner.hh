@@ -18,10 +18,16 @@
 #ifndef ASM_LSW_ALIGNER_ALIGNER_HH
 #define ASM_LSW_ALIGNER_ALIGNER_HH
 
+#include <asm_lsw/dna_pattern.hh>
 #include <asm_lsw/kn_matcher.hh>
+#include <asm_lsw/memory_policy.hh>
+#include <sdsl/lcp_bitcompressed.hpp>
 #include <sdsl/lcp_support_sada.hpp>
 #include <sdsl/csa_rao.hpp>
+#include <sdsl/csa_sada.hpp>
 #include <sdsl/cst_sada.hpp>
+#include <sdsl/structure_tree.hpp>
+#include "index_header.hh"
 
 
 enum class reporting_style : uint8_t
@@ -31,8 +37,46 @@ enum class reporting_style : uint8_t
 };
 
 
-typedef sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <0, 0>>, sdsl::lcp_support_sada <>> cst_type;
-typedef asm_lsw::kn_matcher <cst_type> kn_matcher_type;
+enum class size_report_format : uint8_t
+{
+	json,
+	html
+};
+
+
+// The matchers identify the nodes by their positions in the balanced parentheses
+// representation, so the topology is always that of cst_sada.
+template <cst_backend t_backend>
+struct cst_backend_types {};
+
+template <>
+struct cst_backend_types <cst_backend::compact>
+{
+	typedef sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <0, 0>>, sdsl::lcp_support_sada <>> cst_type;
+	typedef asm_lsw::kn_matcher <cst_type> kn_matcher_type;
+};
+
+template <>
+struct cst_backend_types <cst_backend::fast>
+{
+	typedef sdsl::cst_sada <sdsl::csa_sada <sdsl::enc_vector <>, 8, 8>, sdsl::lcp_bitcompressed <>> cst_type;
+	typedef asm_lsw::kn_matcher <cst_type> kn_matcher_type;
+};
+
+
+// Approximate peak memory use of in-memory suffix sorting per text character with
+// 64-bit suffix array entries, including the text.
+std::size_t const in_memory_sa_bytes_per_char{9};
+
+
+// Return true if sorting the suffixes of a text of text_length characters in memory
+// would exceed memory_budget bytes, zero meaning no limit. Only the suffix array is
+// covered by the budget; the LCP array, the balanced parentheses and the matcher are
+// still constructed in memory.
+inline bool use_semi_external_sa(std::size_t const memory_budget, std::size_t const text_length)
+{
+	return (memory_budget && memory_budget / in_memory_sa_bytes_per_char < text_length);
+}
 
 
 extern "C" void align(
@@ -41,9 +85,28 @@ extern "C" void align(
 	short const k,
 	reporting_style const rs,
 	bool const report_all,
-	bool const single_thread
+	bool const single_thread,
+	bool const verify_index,
+	bool const dna,
+	asm_lsw::dna_n_policy const n_policy,
+	asm_lsw::huge_page_policy const hp,
+	asm_lsw::numa_policy const np
+);
+extern "C" void create_index(
+	std::istream &source_stream,
+	char const *size_report_fname,
+	char const *temp_dir,
+	size_report_format const srf,
+	std::size_t const child_table_depth,
+	std::size_t const sa_memory_budget,
+	cst_backend const backend
+);
+extern "C" void write_size_report(
+	sdsl::structure_tree_node const &root,
+	char const *size_report_fname,
+	size_report_format const srf
 );
-extern "C" void create_index(std::istream &source_stream);
+extern "C" void compare_size_reports(char const *old_fname, char const *new_fname);
 extern "C" void handle_error();
 extern "C" void loading_complete();
 
@@ -18,59 +18,182 @@
 #include <asm_lsw/fasta_reader.hh>
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <cerrno>
 #include <fcntl.h>
 #include <iostream>
+#include <memory>
 #include <sdsl/psi_k_support.hpp>
 #include <sdsl/csa_rao_builder.hpp>
 #include <sdsl/io.hpp>
+#include <string>
 #include <unistd.h>
+#include <vector>
 #include "aligner.hh"
 
 namespace ios = boost::iostreams;
 
 
+namespace {
+	
+	// Remove the temporary copy of the text unless it has been removed already.
+	void remove_temp_file(char const *fname)
+	{
+		if (-1 == unlink(fname) && ENOENT != errno)
+			handle_error();
+	}
+	
+	
+	void index_creation_error(std::string const &error)
+	{
+		std::cerr << "Error: unable to create the index: " << error << '.' << std::endl;
+		exit(EXIT_FAILURE);
+	}
+}
+
+
 class create_index_cb
 {
 protected:
 	char const *m_source_fname{};
+	char const *m_size_report_fname{};
+	char const *m_temp_dir{};
 	std::ostream *m_output_stream{};
+	std::size_t m_child_table_depth{0};
+	std::size_t m_sa_memory_budget{0};
+	std::size_t m_sequence_length{0};
+	size_report_format m_size_report_format{size_report_format::json};
+	cst_backend m_backend{cst_backend::compact};
 	bool m_handled_seq{false};
 	
+protected:
+	template <cst_backend t_backend>
+	void create_and_serialize()
+	{
+		typedef typename cst_backend_types <t_backend>::cst_type cst_type;
+		typedef typename cst_backend_types <t_backend>::kn_matcher_type kn_matcher_type;
+		
+		// Keep the intermediate data structures in the temporary directory. Use semi-external
+		// suffix sorting if in-memory sorting would exceed the budget. The budget does not
+		// cover the rest of the construction.
+		if (use_semi_external_sa(m_sa_memory_budget, m_sequence_length))
+		{
+			std::cerr << "Using semi-external suffix sorting…" << std::endl;
+			sdsl::construct_config::byte_algo_sa = sdsl::SE_SAIS;
+		}
+		
+		// Read the sequence from the file.
+		std::cerr << "Creating the CST…" << std::endl;
+		cst_type cst;
+		sdsl::cache_config config(true, m_temp_dir);
+		sdsl::construct(cst, m_source_fname, config, 1);
+		
+		// The text is not needed after constructing the CST.
+		remove_temp_file(m_source_fname);
+		
+		// Other data structures.
+		std::cerr << "Creating other data structures…" << std::endl;
+		kn_matcher_type matcher(cst, true, m_child_table_depth);
+		
+		// Write each section once and compute its size and checksum at the same time. Collect
+		// the component sizes with the usual structure if requested.
+		std::cerr << "Serializing…" << std::endl;
+		std::unique_ptr <sdsl::structure_tree_node> st_root;
+		if (m_size_report_fname)
+			st_root.reset(new sdsl::structure_tree_node("index", "asm_lsw_index"));
+		
+		// Store the matcher components in separate sections so that they may be loaded concurrently.
+		typedef typename kn_matcher_type::k1_matcher_type k1_matcher_type;
+		typedef typename k1_matcher_type::component component;
+		auto const &base_matcher(matcher.matcher());
+		std::string const matcher_name(sdsl::util::class_name(matcher));
+		
+		index_header header(t_backend);
+		header.write_prefix(std::cout);
+		header.write_section(std::cout, index_section::cst, cst, st_root.get(), "cst");
+		
+		auto *matcher_node(sdsl::structure_tree::add_child(st_root.get(), "matcher", matcher_name));
+		auto *k1_matcher_node(sdsl::structure_tree::add_child(matcher_node, "k1_matcher", sdsl::util::class_name(base_matcher)));
+		std::size_t matcher_bytes(0);
+		for (std::size_t i(0); i < k1_matcher_type::s_component_count; ++i)
+		{
+			auto const c(static_cast <component>(i));
+			auto const type_id(index_type_id(matcher_name + "/" + k1_matcher_type::component_name(c)));
+			header.write_section(std::cout, matcher_section(c), type_id, [&](std::ostream &stream){
+				matcher_bytes += base_matcher.serialize_component(c, stream, k1_matcher_node);
+			});
+		}
+		sdsl::structure_tree::add_size(k1_matcher_node, matcher_bytes);
+		sdsl::structure_tree::add_size(matcher_node, matcher_bytes);
+		
+		header.write_table_of_contents(std::cout);
+		std::cout.flush();
+		
+		if (st_root)
+		{
+			std::cerr << "Writing the size report…" << std::endl;
+			write_size_report(*st_root, m_size_report_fname, m_size_report_format);
+		}
+	}
+	
 public:
-	create_index_cb(char const *source_fname, std::ostream &output_stream):
+	create_index_cb(
+		char const *source_fname,
+		std::ostream &output_stream,
+		char const *size_report_fname,
+		char const *temp_dir,
+		size_report_format const srf,
+		std::size_t const child_table_depth,
+		std::size_t const sa_memory_budget,
+		cst_backend const backend
+	):
 		m_source_fname(source_fname),
-		m_output_stream(&output_stream)
+		m_size_report_fname(size_report_fname),
+		m_temp_dir(temp_dir),
+		m_output_stream(&output_stream),
+		m_child_table_depth(child_table_depth),
+		m_sa_memory_budget(sa_memory_budget),
+		m_size_report_format(srf),
+		m_backend(backend)
 	{
 		assert(m_source_fname);
+		assert(m_temp_dir);
 	}
 	
-	void handle_sequence(
-		std::string const &identifier,
-		std::unique_ptr <std::vector <char>> &seq,
-		asm_lsw::vector_source &vs
-	)
+	void begin_sequence(std::string const &identifier)
 	{
 		if (m_handled_seq)
 			throw std::runtime_error("Read more than one sequence");
-		
+	}
+	
+	void handle_chunk(char const *data, std::size_t const size)
+	{
 		// Write the sequence to the specified file.
-		std::copy(seq->begin(), seq->end(), std::ostream_iterator <char>(*m_output_stream));
-		m_output_stream->flush();
-		vs.put_vector(seq);
-		
-		// Read the sequence from the file.
-		std::cerr << "Creating the CST…" << std::endl;
-		cst_type cst;
-		sdsl::construct(cst, m_source_fname, 1);
+		m_output_stream->write(data, size);
+		m_sequence_length += size;
+	}
+	
+	void end_sequence()
+	{
+		// Skip empty sequences.
+		if (0 == m_sequence_length)
+			return;
 		
-		// Other data structures.
-		std::cerr << "Creating other data structures…" << std::endl;
-		kn_matcher_type matcher(cst);
+		m_output_stream->flush();
 		
-		// Serialize.
-		std::cerr << "Serializing…" << std::endl;
-		sdsl::serialize(cst, std::cout);
-		sdsl::serialize(matcher, std::cout);
+		switch (m_backend)
+		{
+			case cst_backend::compact:
+				create_and_serialize <cst_backend::compact>();
+				break;
+				
+			case cst_backend::fast:
+				create_and_serialize <cst_backend::fast>();
+				break;
+				
+			default:
+				assert(0);
+				break;
+		}
 		
 		m_handled_seq = true;
 	}
@@ -79,28 +202,54 @@ public:
 };
 
 
-void create_index(std::istream &source_stream)
+void create_index(
+	std::istream &source_stream,
+	char const *size_report_fname,
+	char const *temp_dir,
+	size_report_format const srf,
+	std::size_t const child_table_depth,
+	std::size_t const sa_memory_budget,
+	cst_backend const backend
+)
 {
 	// SDSL reads the whole string from a file so copy the contents without the newlines
-	// into a temporary file, then create the index.
-	char temp_fname[]{"/tmp/asm_lsw_aligner_XXXXXX"};
-	int const temp_fd(mkstemp(temp_fname));
+	// into a temporary file, then create the index. The sequence is copied one line at a
+	// time so that it does not need to fit into memory.
+	std::string const temp_fname_tpl(std::string(temp_dir) + "/asm_lsw_aligner_XXXXXX");
+	std::vector <char> temp_fname(temp_fname_tpl.cbegin(), temp_fname_tpl.cend());
+	temp_fname.push_back('\0');
+	int const temp_fd(mkstemp(temp_fname.data()));
 	if (-1 == temp_fd)
 		handle_error();
 	
 	try
 	{
 		// Read the sequence from input and create the index in the callback.
-		asm_lsw::vector_source vs(1, false);
-		asm_lsw::fasta_reader <create_index_cb, 10 * 1024 * 1024> reader;
+		asm_lsw::fasta_chunk_reader <create_index_cb> reader;
 		ios::stream <ios::file_descriptor_sink> output_stream(temp_fd, ios::close_handle);
-		create_index_cb cb(temp_fname, output_stream);
+		create_index_cb cb(
+			temp_fname.data(),
+			output_stream,
+			size_report_fname,
+			temp_dir,
+			srf,
+			child_table_depth,
+			sa_memory_budget,
+			backend
+		);
 		
-		reader.read_from_stream(source_stream, vs, cb);
+		reader.read_from_stream(source_stream, cb);
+	}
+	catch (std::exception const &exc)
+	{
+		remove_temp_file(temp_fname.data());
+		index_creation_error(exc.what());
 	}
 	catch (...)
 	{
-		if (-1 == unlink(temp_fname))
-			handle_error();
+		remove_temp_file(temp_fname.data());
+		index_creation_error("unknown error");
 	}
+	
+	remove_temp_file(temp_fname.data());
 }
@@ -0,0 +1,200 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "index_header.hh"
+
+
+char const index_header::s_magic[8]{'A', 'S', 'M', 'L', 'S', 'W', 'I', 'X'};
+uint32_t const index_header::s_version{3};
+
+
+namespace {
+	
+	uint64_t const s_entry_size(4 + 4 + 8 + 8 + 8);
+	uint64_t const s_prefix_size(sizeof(index_header::s_magic) + 4 + 1);
+}
+
+
+uint64_t index_type_id(std::string const &name)
+{
+	// FNV-1a.
+	uint64_t retval(UINT64_C(14695981039346656037));
+	for (unsigned char const c : name)
+	{
+		retval ^= c;
+		retval *= UINT64_C(1099511628211);
+	}
+	return retval;
+}
+
+
+index_section_entry const &index_header::section(index_section const section) const
+{
+	auto const it(std::find_if(m_sections.cbegin(), m_sections.cend(), [section](index_section_entry const &entry){
+		return entry.section == section;
+	}));
+	
+	if (m_sections.cend() == it)
+		throw std::runtime_error("Section not found in the index");
+	
+	return *it;
+}
+
+
+void index_header::write_prefix(std::ostream &out)
+{
+	out.write(s_magic, sizeof(s_magic));
+	sdsl::write_member(s_version, out);
+	sdsl::write_member(static_cast <uint8_t>(m_backend), out);
+	
+	m_sections.clear();
+	m_data_end = s_prefix_size;
+}
+
+
+void index_header::write_table_of_contents(std::ostream &out) const
+{
+	sdsl::write_member(static_cast <uint32_t>(m_sections.size()), out);
+	for (auto const &entry : m_sections)
+	{
+		sdsl::write_member(static_cast <uint32_t>(entry.section), out);
+		sdsl::write_member(entry.checksum, out);
+		sdsl::write_member(entry.type_id, out);
+		sdsl::write_member(entry.offset, out);
+		sdsl::write_member(entry.size, out);
+	}
+	
+	// The reader finds the table of contents with the trailing offset.
+	sdsl::write_member(m_data_end, out);
+}
+
+
+bool index_header::read(std::istream &in, std::string &error)
+{
+	char magic[sizeof(s_magic)]{};
+	in.read(magic, sizeof(magic));
+	if (! (in && 0 == memcmp(magic, s_magic, sizeof(s_magic))))
+	{
+		error = "not an index file";
+		return false;
+	}
+	
+	uint32_t version(0);
+	sdsl::read_member(version, in);
+	if (! (in && s_version == version))
+	{
+		error = "unsupported index version";
+		return false;
+	}
+	
+	uint8_t backend(0);
+	sdsl::read_member(backend, in);
+	if (! (in && backend <= static_cast <uint8_t>(cst_backend::fast)))
+	{
+		error = "unknown CST backend";
+		return false;
+	}
+	m_backend = static_cast <cst_backend>(backend);
+	
+	// Locate the table of contents.
+	uint64_t toc_offset(0);
+	in.seekg(-static_cast <std::streamoff>(sizeof(toc_offset)), std::ios_base::end);
+	auto const toc_end(in.tellg());
+	sdsl::read_member(toc_offset, in);
+	if (! (in && s_prefix_size <= toc_offset && toc_offset < static_cast <uint64_t>(toc_end)))
+	{
+		error = "truncated header";
+		return false;
+	}
+	
+	// Bound the section count by the number of known sections instead of trusting the file.
+	uint32_t section_count(0);
+	in.seekg(toc_offset);
+	sdsl::read_member(section_count, in);
+	if (! (in && section_count <= index_section_count && toc_offset + 4 + section_count * s_entry_size == static_cast <uint64_t>(toc_end)))
+	{
+		error = "invalid section count";
+		return false;
+	}
+	
+	m_sections.clear();
+	m_sections.reserve(section_count);
+	for (uint32_t i(0); i < section_count; ++i)
+	{
+		uint32_t section(0);
+		index_section_entry entry;
+		sdsl::read_member(section, in);
+		sdsl::read_member(entry.checksum, in);
+		sdsl::read_member(entry.type_id, in);
+		sdsl::read_member(entry.offset, in);
+		sdsl::read_member(entry.size, in);
+		
+		if (! (section < index_section_count && entry.offset <= toc_offset && entry.size <= toc_offset - entry.offset))
+		{
+			error = "invalid section";
+			return false;
+		}
+		
+		entry.section = static_cast <index_section>(section);
+		m_sections.push_back(entry);
+	}
+	m_data_end = toc_offset;
+	
+	if (!in)
+	{
+		error = "truncated header";
+		return false;
+	}
+	
+	return true;
+}
+
+
+bool index_header::check_type(index_section const section, uint64_t const type_id, std::string &error) const
+{
+	if (this->section(section).type_id != type_id)
+	{
+		error = "section type mismatch";
+		return false;
+	}
+	return true;
+}
+
+
+bool index_header::verify_checksum(std::istream &in, index_section_entry const &entry) const
+{
+	in.seekg(entry.offset);
+	
+	boost::crc_32_type crc;
+	std::vector <char> buffer(1024 * 1024);
+	uint64_t remaining(entry.size);
+	while (remaining)
+	{
+		auto const count(std::min <uint64_t>(remaining, buffer.size()));
+		in.read(buffer.data(), count);
+		if (!in)
+			return false;
+		
+		crc.process_bytes(buffer.data(), count);
+		remaining -= count;
+	}
+	
+	return (crc.checksum() == entry.checksum);
+}
@@ -0,0 +1,232 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+
+#ifndef ASM_LSW_ALIGNER_INDEX_HEADER_HH
+#define ASM_LSW_ALIGNER_INDEX_HEADER_HH
+
+#include <boost/crc.hpp>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sdsl/io.hpp>
+#include <sdsl/structure_tree.hpp>
+#include <sdsl/util.hpp>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+
+enum class cst_backend : uint8_t
+{
+	compact,	// csa_rao with a compressed LCP array.
+	fast		// csa_sada with dense SA and ISA samples and a bit-compressed LCP array.
+};
+
+
+// The matcher components follow the CST in the order of k1_matcher::component.
+enum class index_section : uint32_t
+{
+	cst,
+	matcher_gamma,
+	matcher_core_endpoints,
+	matcher_lcp_rmq,
+	matcher_h,
+	matcher_child_table
+};
+
+// Number of known section types; bounds the table of contents when reading.
+uint32_t const index_section_count(1 + static_cast <uint32_t>(index_section::matcher_child_table));
+
+
+template <typename t_component>
+index_section matcher_section(t_component const c)
+{
+	return static_cast <index_section>(1 + static_cast <uint32_t>(c));
+}
+
+
+struct index_section_entry
+{
+	index_section	section{};
+	uint32_t		checksum{0};	// CRC-32 of the section.
+	uint64_t		type_id{0};		// Hash of the serialized type's name.
+	uint64_t		offset{0};		// From the beginning of the file.
+	uint64_t		size{0};
+};
+
+
+// Passes the written bytes to another stream buffer and computes their number and CRC-32.
+class checksum_tee_streambuf : public std::streambuf
+{
+protected:
+	std::streambuf		*m_target{};
+	boost::crc_32_type	m_crc;
+	uint64_t			m_size{0};
+	
+public:
+	checksum_tee_streambuf(std::streambuf &target):
+		m_target(&target)
+	{
+	}
+	
+	uint64_t size() const { return m_size; }
+	uint32_t checksum() const { return m_crc.checksum(); }
+	
+protected:
+	virtual int_type overflow(int_type c) override
+	{
+		if (traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::not_eof(c);
+		
+		char const ch(traits_type::to_char_type(c));
+		return (1 == xsputn(&ch, 1) ? c : traits_type::eof());
+	}
+	
+	virtual std::streamsize xsputn(char const *s, std::streamsize n) override
+	{
+		auto const count(m_target->sputn(s, n));
+		m_crc.process_bytes(s, count);
+		m_size += count;
+		return count;
+	}
+	
+	virtual int sync() override
+	{
+		return m_target->pubsync();
+	}
+};
+
+
+// Header of the index file. The sections are written only once, so their sizes and checksums
+// are known only after writing them and the table of contents is stored after the sections.
+// Layout: magic, version, backend, the sections, section count, one entry per section and
+// finally the offset of the section count.
+class index_header
+{
+public:
+	static char const s_magic[8];
+	static uint32_t const s_version;
+	
+protected:
+	std::vector <index_section_entry>	m_sections;
+	uint64_t							m_data_end{0};
+	cst_backend							m_backend{cst_backend::compact};
+	
+public:
+	index_header() {}
+	
+	index_header(cst_backend const backend):
+		m_backend(backend)
+	{
+	}
+	
+	cst_backend backend() const { return m_backend; }
+	std::vector <index_section_entry> const &sections() const { return m_sections; }
+	
+	// Write the magic number, the version and the backend.
+	void write_prefix(std::ostream &out);
+	
+	// Call serialize_fn with a stream that passes the data to out while determining
+	// its size and checksum, and add a section for it.
+	template <typename t_serialize_fn>
+	void write_section(std::ostream &out, index_section const section, uint64_t const type_id, t_serialize_fn &&serialize_fn);
+	
+	// Write value as a section. Fill the structure tree if node is not null.
+	template <typename t_value>
+	void write_section(
+		std::ostream &out,
+		index_section const section,
+		t_value const &value,
+		sdsl::structure_tree_node *node = nullptr,
+		std::string const &name = ""
+	);
+	
+	// Write the table of contents after the sections.
+	void write_table_of_contents(std::ostream &out) const;
+	
+	// Return the section or throw if not found.
+	index_section_entry const &section(index_section const section) const;
+	
+	// Read the header and check the magic number, the version and the backend, then read the
+	// table of contents from the end of the file. Return false and set error if the index is
+	// not compatible.
+	bool read(std::istream &in, std::string &error);
+	
+	// Compare the section's type identifier. Return false and set error on mismatch.
+	bool check_type(index_section const section, uint64_t const type_id, std::string &error) const;
+	
+	template <typename t_value>
+	bool check_type(index_section const section, t_value const &value, std::string &error) const;
+	
+	// Read the section and compare its checksum.
+	bool verify_checksum(std::istream &in, index_section_entry const &entry) const;
+};
+
+
+// Identify a type by the hash of its name.
+uint64_t index_type_id(std::string const &name);
+
+
+template <typename t_value>
+uint64_t index_type_id(t_value const &value)
+{
+	return index_type_id(sdsl::util::class_name(value));
+}
+
+
+template <typename t_serialize_fn>
+void index_header::write_section(std::ostream &out, index_section const section, uint64_t const type_id, t_serialize_fn &&serialize_fn)
+{
+	checksum_tee_streambuf buf(*out.rdbuf());
+	std::ostream stream(&buf);
+	serialize_fn(stream);
+	if (!stream)
+		out.setstate(std::ios_base::badbit);
+	
+	index_section_entry entry;
+	entry.section = section;
+	entry.checksum = buf.checksum();
+	entry.type_id = type_id;
+	entry.offset = m_data_end;
+	entry.size = buf.size();
+	m_sections.push_back(entry);
+	m_data_end += entry.size;
+}
+
+
+template <typename t_value>
+void index_header::write_section(
+	std::ostream &out,
+	index_section const section,
+	t_value const &value,
+	sdsl::structure_tree_node *node,
+	std::string const &name
+)
+{
+	write_section(out, section, index_type_id(value), [&](std::ostream &stream){
+		sdsl::serialize(value, stream, node, name);
+	});
+}
+
+
+template <typename t_value>
+bool index_header::check_type(index_section const section, t_value const &value, std::string &error) const
+{
+	return check_type(section, index_type_id(value), error);
+}
+
+#endif
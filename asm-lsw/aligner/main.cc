@@ -88,21 +88,61 @@ int main(int argc, char **argv)
 	
 	if (args_info.create_index_given)
 	{
+		char const *size_report_fname(args_info.size_report_given ? args_info.size_report_arg : nullptr);
+		size_report_format const srf(
+			0 == strcmp(args_info.size_report_format_arg, "html") ? size_report_format::html : size_report_format::json
+		);
+		
+		if (args_info.child_table_depth_arg < 0)
+		{
+			std::cerr << "The child table depth must be non-negative." << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		std::size_t const child_table_depth(args_info.child_table_depth_arg);
+		
+		if (args_info.sa_memory_budget_arg < 0)
+		{
+			std::cerr << "The suffix sorting memory budget must be non-negative." << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		std::size_t const sa_memory_budget(std::size_t(args_info.sa_memory_budget_arg) * 1024 * 1024);
+		
+		cst_backend const backend(0 == strcmp(args_info.cst_backend_arg, "fast") ? cst_backend::fast : cst_backend::compact);
+		
 		if (args_info.source_file_given)
 		{
 			int fd(open(args_info.source_file_arg, O_RDONLY | O_SHLOCK));
 			if (-1 == fd)
 				handle_error();
 			ios::stream <ios::file_descriptor_source> source_stream(fd, ios::close_handle);
-			create_index(source_stream);
+			create_index(source_stream, size_report_fname, args_info.temp_dir_arg, srf, child_table_depth, sa_memory_budget, backend);
 		}
 		else
 		{
-			create_index(std::cin);
+			create_index(std::cin, size_report_fname, args_info.temp_dir_arg, srf, child_table_depth, sa_memory_budget, backend);
 		}
 	}
+	else if (args_info.compare_size_reports_given)
+	{
+		assert(2 == args_info.compare_size_reports_given);
+		compare_size_reports(args_info.compare_size_reports_arg[0], args_info.compare_size_reports_arg[1]);
+	}
 	else if (args_info.align_given)
 	{
+		asm_lsw::huge_page_policy hp(asm_lsw::huge_page_policy::none);
+		if (0 == strcmp(args_info.huge_pages_arg, "transparent"))
+			hp = asm_lsw::huge_page_policy::transparent;
+		else if (0 == strcmp(args_info.huge_pages_arg, "explicit"))
+			hp = asm_lsw::huge_page_policy::explicit_pages;
+		
+		asm_lsw::numa_policy const np(
+			0 == strcmp(args_info.numa_arg, "interleave") ? asm_lsw::numa_policy::interleave : asm_lsw::numa_policy::none
+		);
+		
+		asm_lsw::dna_n_policy const n_policy(
+			0 == strcmp(args_info.n_policy_arg, "reject") ? asm_lsw::dna_n_policy::reject : asm_lsw::dna_n_policy::mismatch
+		);
+		
 		s_in_align_mode = true;
 		align(
 			args_info.source_file_given ? args_info.source_file_arg : nullptr,
@@ -110,7 +150,12 @@ int main(int argc, char **argv)
 			args_info.error_count_arg,
 			(args_info.report_csa_ranges_given ? reporting_style::csa_ranges : reporting_style::text_positions),
 			args_info.report_all_given,
-			args_info.no_mt_given
+			args_info.no_mt_given,
+			args_info.verify_index_given,
+			args_info.dna_given,
+			n_policy,
+			hp,
+			np
 		);
 	}
 	else
@@ -0,0 +1,125 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+
+#include <boost/format.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sdsl/structure_tree.hpp>
+#include <string>
+#include "aligner.hh"
+
+namespace pt = boost::property_tree;
+
+
+namespace {
+	
+	typedef std::map <std::string, std::size_t> component_size_map;
+	
+	
+	// Flatten the tree written by sdsl::write_structure_tree into component paths and sizes.
+	// Nodes without a name are identified by their class name.
+	void add_component_sizes(pt::ptree const &node, std::string const &parent_path, component_size_map &sizes)
+	{
+		auto const name(node.get <std::string>("name", ""));
+		auto const class_name(node.get <std::string>("class_name", ""));
+		auto const path(parent_path + "/" + (name.empty() ? class_name : name));
+		sizes[path] += node.get <std::size_t>("size", 0);
+		
+		auto const children(node.get_child_optional("children"));
+		if (children)
+		{
+			for (auto const &kv : *children)
+				add_component_sizes(kv.second, path, sizes);
+		}
+	}
+	
+	
+	void read_size_report(char const *fname, component_size_map &sizes)
+	{
+		pt::ptree root;
+		try
+		{
+			pt::read_json(fname, root);
+		}
+		catch (pt::json_parser_error const &exc)
+		{
+			std::cerr << "Unable to read the size report " << fname << ": " << exc.what() << std::endl;
+			exit(EXIT_FAILURE);
+		}
+		
+		add_component_sizes(root, "", sizes);
+	}
+}
+
+
+void write_size_report(
+	sdsl::structure_tree_node const &root,
+	char const *size_report_fname,
+	size_report_format const srf
+)
+{
+	std::ofstream out(size_report_fname);
+	if (!out)
+	{
+		std::cerr << "Unable to open the size report file " << size_report_fname << " for writing." << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	
+	switch (srf)
+	{
+		case size_report_format::json:
+			sdsl::write_structure_tree <sdsl::JSON_FORMAT>(&root, out);
+			break;
+			
+		case size_report_format::html:
+			sdsl::write_structure_tree <sdsl::HTML_FORMAT>(&root, out);
+			break;
+	}
+}
+
+
+void compare_size_reports(char const *old_fname, char const *new_fname)
+{
+	component_size_map old_sizes, new_sizes;
+	read_size_report(old_fname, old_sizes);
+	read_size_report(new_fname, new_sizes);
+	
+	// Components that are missing from one of the reports have size zero.
+	for (auto const &kv : old_sizes)
+		new_sizes.emplace(kv.first, 0);
+	for (auto const &kv : new_sizes)
+		old_sizes.emplace(kv.first, 0);
+	
+	std::cout << "component\told\tnew\tdifference\tchange_percent" << std::endl;
+	for (auto const &kv : new_sizes)
+	{
+		auto const old_size(old_sizes[kv.first]);
+		auto const new_size(kv.second);
+		auto const diff(static_cast <std::ptrdiff_t>(new_size) - static_cast <std::ptrdiff_t>(old_size));
+		
+		std::cout << kv.first << '\t' << old_size << '\t' << new_size << '\t' << diff << '\t';
+		if (old_size)
+			std::cout << boost::format("%.2f") % (100.0 * diff / old_size);
+		else
+			std::cout << '-';
+		std::cout << std::endl;
+	}
+}
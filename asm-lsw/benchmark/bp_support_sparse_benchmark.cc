@@ -0,0 +1,144 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/bp_support_sparse.hh>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sdsl/sd_vector.hpp>
+#include <string>
+#include <vector>
+
+
+// Compare the query times of bp_support_sparse with different mask representations.
+// Usage: bp_support_sparse_benchmark [pair_count] [space_ratio] [query_count]
+// Prints one tab-separated line per mask type.
+
+typedef asm_lsw::bp_support_sparse <> bps_bit_vector_type;
+typedef asm_lsw::bp_support_sparse_il <> bps_il_type;
+typedef asm_lsw::bp_support_sparse <sdsl::bp_support_g <>, sdsl::sd_vector <>> bps_sd_type;
+typedef bps_bit_vector_type::input_value input_value;
+
+
+namespace {
+	
+	typedef std::chrono::steady_clock clock_type;
+	
+	
+	double seconds_since(clock_type::time_point const start)
+	{
+		std::chrono::duration <double> const elapsed(clock_type::now() - start);
+		return elapsed.count();
+	}
+	
+	
+	// Generate a random balanced parenthesis sequence with space_ratio spaces per parenthesis on average.
+	sdsl::int_vector <8> random_sequence(std::size_t const pair_count, double const space_ratio)
+	{
+		std::mt19937 gen(0);
+		std::bernoulli_distribution open_dist(0.5);
+		std::geometric_distribution <std::size_t> space_dist(1.0 / (1.0 + space_ratio));
+		
+		std::vector <uint8_t> seq;
+		std::size_t opened(0);
+		std::size_t remaining(pair_count);
+		while (remaining || opened)
+		{
+			seq.insert(seq.end(), space_dist(gen), uint8_t(input_value::Space));
+			if (remaining && (0 == opened || open_dist(gen)))
+			{
+				seq.push_back(uint8_t(input_value::Opening));
+				++opened;
+				--remaining;
+			}
+			else
+			{
+				seq.push_back(uint8_t(input_value::Closing));
+				--opened;
+			}
+		}
+		
+		sdsl::int_vector <8> retval(seq.size(), 0);
+		for (std::size_t i(0); i < seq.size(); ++i)
+			retval[i] = seq[i];
+		return retval;
+	}
+	
+	
+	template <typename t_bps>
+	void run(std::string const &name, sdsl::int_vector <8> const &seq, std::vector <std::size_t> const &openings)
+	{
+		t_bps bps(seq);
+		
+		// Closings that match the queried openings.
+		std::vector <std::size_t> closings(openings.size());
+		std::size_t checksum(0);
+		auto start(clock_type::now());
+		for (std::size_t i(0); i < openings.size(); ++i)
+			closings[i] = bps.find_close(openings[i]);
+		auto const find_close_seconds(seconds_since(start));
+		
+		start = clock_type::now();
+		for (auto const idx : closings)
+			checksum += bps.find_open(idx);
+		auto const find_open_seconds(seconds_since(start));
+		
+		start = clock_type::now();
+		for (auto const idx : openings)
+			checksum += bps.enclose(idx);
+		auto const enclose_seconds(seconds_since(start));
+		
+		std::cout
+			<< name << '\t'
+			<< (1e9 * find_open_seconds / openings.size()) << '\t'
+			<< (1e9 * find_close_seconds / openings.size()) << '\t'
+			<< (1e9 * enclose_seconds / openings.size()) << '\t'
+			<< (double(sdsl::size_in_bytes(bps.mask())) / seq.size()) << '\t'
+			<< checksum << std::endl;
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	std::size_t const pair_count(1 < argc ? std::strtoull(argv[1], nullptr, 10) : 10000000);
+	double const space_ratio(2 < argc ? std::strtod(argv[2], nullptr) : 4.0);
+	std::size_t const query_count(3 < argc ? std::strtoull(argv[3], nullptr, 10) : 1000000);
+	
+	auto const seq(random_sequence(pair_count, space_ratio));
+	
+	// Query random opening parentheses.
+	std::vector <std::size_t> all_openings;
+	for (std::size_t i(0); i < seq.size(); ++i)
+	{
+		if (uint8_t(input_value::Opening) == seq[i])
+			all_openings.push_back(i);
+	}
+	
+	std::mt19937 gen(1);
+	std::uniform_int_distribution <std::size_t> dist(0, all_openings.size() - 1);
+	std::vector <std::size_t> openings(query_count);
+	for (auto &idx : openings)
+		idx = all_openings[dist(gen)];
+	
+	std::cout << "mask\tns_per_find_open\tns_per_find_close\tns_per_enclose\tmask_bytes_per_position\tchecksum" << std::endl;
+	run <bps_bit_vector_type>("bit_vector", seq, openings);
+	run <bps_il_type>("bit_vector_il", seq, openings);
+	run <bps_sd_type>("sd_vector", seq, openings);
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/concurrent_y_fast_trie.hh>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+// Measure the query throughput of concurrent_y_fast_trie while one thread inserts keys.
+// Usage: concurrent_y_fast_trie_benchmark [max_threads] [key_count] [publish_interval]
+// Prints one tab-separated line per reader thread count.
+
+typedef asm_lsw::concurrent_y_fast_trie <uint32_t> trie_type;
+
+
+namespace {
+	
+	struct result
+	{
+		std::size_t queries{0};
+		std::size_t inserts{0};
+		double seconds{0};
+	};
+	
+	
+	result run(std::size_t const reader_count, std::size_t const key_count, std::size_t const publish_interval)
+	{
+		trie_type trie(std::numeric_limits <uint32_t>::max(), publish_interval);
+		std::mt19937 gen(0);
+		std::uniform_int_distribution <uint32_t> dist;
+		
+		// Insert half of the keys before starting the readers.
+		std::vector <uint32_t> keys(key_count);
+		for (auto &key : keys)
+			key = dist(gen);
+		
+		for (std::size_t i(0); i < key_count / 2; ++i)
+			trie.insert(keys[i]);
+		trie.synchronize();
+		
+		std::atomic <bool> stop(false);
+		std::vector <std::size_t> query_counts(reader_count, 0);
+		std::vector <std::thread> readers;
+		
+		auto const start(std::chrono::steady_clock::now());
+		for (std::size_t i(0); i < reader_count; ++i)
+		{
+			readers.emplace_back([&trie, &stop, &query_counts, i](){
+				std::mt19937 gen(1 + i);
+				std::uniform_int_distribution <uint32_t> dist;
+				std::size_t count(0);
+				uint32_t key(0);
+				while (!stop.load(std::memory_order_relaxed))
+				{
+					trie.find_successor(dist(gen), key);
+					++count;
+				}
+				query_counts[i] = count;
+			});
+		}
+		
+		// Insert the rest of the keys concurrently.
+		for (std::size_t i(key_count / 2); i < key_count; ++i)
+			trie.insert(keys[i]);
+		trie.synchronize();
+		
+		// Let the readers run for at least a while if there were only a few keys to insert.
+		while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500))
+			std::this_thread::yield();
+		
+		stop = true;
+		for (auto &thread : readers)
+			thread.join();
+		
+		std::chrono::duration <double> const elapsed(std::chrono::steady_clock::now() - start);
+		
+		result res;
+		for (auto const count : query_counts)
+			res.queries += count;
+		res.inserts = key_count - key_count / 2;
+		res.seconds = elapsed.count();
+		return res;
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	std::size_t const max_threads(1 < argc ? std::strtoull(argv[1], nullptr, 10) : std::thread::hardware_concurrency());
+	std::size_t const key_count(2 < argc ? std::strtoull(argv[2], nullptr, 10) : 100000);
+	std::size_t const publish_interval(3 < argc ? std::strtoull(argv[3], nullptr, 10) : 64);
+	
+	std::cout << "readers\tqueries\tinserts\tseconds\tqueries_per_second" << std::endl;
+	for (std::size_t threads(1); threads <= max_threads; threads *= 2)
+	{
+		auto const res(run(threads, key_count, publish_interval));
+		std::cout
+			<< threads << '\t'
+			<< res.queries << '\t'
+			<< res.inserts << '\t'
+			<< res.seconds << '\t'
+			<< (res.queries / res.seconds) << std::endl;
+	}
+	
+	return EXIT_SUCCESS;
+}
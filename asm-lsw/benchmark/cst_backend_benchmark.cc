@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/kn_matcher.hh>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sdsl/construct.hpp>
+#include <sdsl/csa_rao.hpp>
+#include <sdsl/csa_rao_builder.hpp>
+#include <sdsl/csa_sada.hpp>
+#include <sdsl/cst_sada.hpp>
+#include <sdsl/lcp_bitcompressed.hpp>
+#include <sdsl/lcp_support_sada.hpp>
+#include <string>
+#include <vector>
+
+
+// Compare the time and space used by the CST backends of the aligner.
+// Usage: cst_backend_benchmark [text_file] [read_count] [read_length] [k]
+// The text file should contain the reference without newlines. If it is not given,
+// a random nucleotide sequence is used.
+// Prints a tab-separated table with one line per backend.
+
+namespace {
+	
+	typedef std::chrono::steady_clock clock_type;
+	
+	typedef sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <0, 0>>, sdsl::lcp_support_sada <>> compact_cst_type;
+	typedef sdsl::cst_sada <sdsl::csa_sada <sdsl::enc_vector <>, 8, 8>, sdsl::lcp_bitcompressed <>> fast_cst_type;
+	
+	
+	double seconds_since(clock_type::time_point const start)
+	{
+		std::chrono::duration <double> const elapsed(clock_type::now() - start);
+		return elapsed.count();
+	}
+	
+	
+	std::string random_text(std::size_t const length, uint32_t const seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution <unsigned int> dist(0, 3);
+		std::string text(length, 'A');
+		for (auto &c : text)
+			c = "ACGT"[dist(gen)];
+		return text;
+	}
+	
+	
+	// Take substrings of the text and change one character in each.
+	std::vector <std::string> sample_reads(
+		std::string const &text,
+		std::size_t const count,
+		std::size_t const length,
+		uint32_t const seed
+	)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution <std::size_t> pos_dist(0, text.size() - length);
+		std::uniform_int_distribution <std::size_t> idx_dist(0, length - 1);
+		std::uniform_int_distribution <unsigned int> char_dist(0, 3);
+		
+		std::vector <std::string> reads(count);
+		for (auto &read : reads)
+		{
+			read = text.substr(pos_dist(gen), length);
+			read[idx_dist(gen)] = "ACGT"[char_dist(gen)];
+		}
+		return reads;
+	}
+	
+	
+	template <typename t_cst>
+	void run_backend(
+		char const *name,
+		std::string const &text_fname,
+		std::vector <std::string> const &reads,
+		uint8_t const k
+	)
+	{
+		typedef asm_lsw::kn_matcher <t_cst> kn_matcher_type;
+		
+		auto const cst_start(clock_type::now());
+		t_cst cst;
+		sdsl::construct(cst, text_fname, 1);
+		auto const cst_seconds(seconds_since(cst_start));
+		
+		auto const matcher_start(clock_type::now());
+		kn_matcher_type matcher(cst);
+		auto const matcher_seconds(seconds_since(matcher_start));
+		
+		std::size_t found(0);
+		auto const query_start(clock_type::now());
+		for (auto const &read : reads)
+		{
+			typename kn_matcher_type::csa_ranges ranges;
+			matcher.template find_approximate <false>(read, k, ranges);
+			if (ranges.size())
+				++found;
+		}
+		auto const query_seconds(seconds_since(query_start));
+		
+		auto const cst_bytes(sdsl::size_in_bytes(cst));
+		auto const matcher_bytes(sdsl::size_in_bytes(matcher));
+		
+		std::cout
+			<< name << '\t'
+			<< cst_seconds << '\t'
+			<< matcher_seconds << '\t'
+			<< (1e6 * query_seconds / reads.size()) << '\t'
+			<< (double(cst_bytes) / cst.size()) << '\t'
+			<< (double(matcher_bytes) / cst.size()) << '\t'
+			<< found << std::endl;
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	std::size_t const read_count(2 < argc ? std::strtoull(argv[2], nullptr, 10) : 10000);
+	std::size_t const read_length(3 < argc ? std::strtoull(argv[3], nullptr, 10) : 100);
+	uint8_t const k(4 < argc ? std::strtoul(argv[4], nullptr, 10) : 1);
+	
+	std::string text_fname;
+	std::string text;
+	if (1 < argc)
+	{
+		text_fname = argv[1];
+		std::ifstream stream(text_fname);
+		text.assign(std::istreambuf_iterator <char>(stream), std::istreambuf_iterator <char>());
+	}
+	else
+	{
+		text_fname = "@cst_backend_benchmark_input.txt";
+		text = random_text(1000000, 0);
+		std::ofstream stream(text_fname);
+		stream << text;
+	}
+	
+	if (text.size() < read_length)
+	{
+		std::cerr << "The text is shorter than the reads." << std::endl;
+		return EXIT_FAILURE;
+	}
+	
+	auto const reads(sample_reads(text, read_count, read_length, 1));
+	
+	std::cout << "backend\tcst_seconds\tmatcher_seconds\tus_per_read\tcst_bytes_per_char\tmatcher_bytes_per_char\tfound" << std::endl;
+	run_backend <compact_cst_type>("compact", text_fname, reads, k);
+	run_backend <fast_cst_type>("fast", text_fname, reads, k);
+	
+	return EXIT_SUCCESS;
+}
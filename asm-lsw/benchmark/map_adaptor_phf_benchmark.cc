@@ -0,0 +1,183 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/map_adaptor_phf.hh>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+
+// Measure the effect of the PHF construction parameters on map_adaptor_phf and
+// compare the serial and the parallel builders.
+// Usage: map_adaptor_phf_benchmark [key_count] [map_count] [max_threads]
+// Prints two tab-separated tables, one line per parameter combination and thread count.
+
+typedef std::map <uint32_t, uint32_t> map_type;
+
+
+namespace {
+	
+	typedef std::chrono::steady_clock clock_type;
+	
+	
+	double seconds_since(clock_type::time_point const start)
+	{
+		std::chrono::duration <double> const elapsed(clock_type::now() - start);
+		return elapsed.count();
+	}
+	
+	
+	std::vector <uint32_t> random_keys(std::size_t const count, uint32_t const seed)
+	{
+		std::mt19937 gen(seed);
+		std::uniform_int_distribution <uint32_t> dist;
+		std::vector <uint32_t> keys(count);
+		for (auto &key : keys)
+			key = dist(gen);
+		return keys;
+	}
+	
+	
+	template <std::size_t t_lambda, std::size_t t_alpha>
+	void run_parameters(map_type const &values, std::vector <uint32_t> const &queries)
+	{
+		typedef asm_lsw::map_adaptor_phf_spec <
+			std::vector, std::allocator, uint32_t, uint32_t, true, asm_lsw::map_adaptor_access_key <uint32_t>, t_lambda, t_alpha
+		> spec_type;
+		typedef asm_lsw::map_adaptor_phf <spec_type> adaptor_type;
+		
+		map_type values_copy(values);
+		auto const build_start(clock_type::now());
+		typename adaptor_type::template builder_type <map_type> builder(values_copy);
+		adaptor_type adaptor(builder);
+		auto const build_seconds(seconds_since(build_start));
+		
+		std::size_t found(0);
+		auto const query_start(clock_type::now());
+		for (auto const key : queries)
+		{
+			if (adaptor.find(key) != adaptor.cend())
+				++found;
+		}
+		auto const query_seconds(seconds_since(query_start));
+		
+		std::ostringstream os;
+		std::size_t const bytes(adaptor.serialize(os));
+		
+		std::cout
+			<< t_lambda << '\t'
+			<< t_alpha << '\t'
+			<< build_seconds << '\t'
+			<< (1e9 * query_seconds / queries.size()) << '\t'
+			<< (double(bytes) / values.size()) << '\t'
+			<< found << std::endl;
+	}
+	
+	
+	// Construct a map_adaptor_phf of keys for each value of the outer map.
+	typedef asm_lsw::map_adaptor_phf_spec <std::vector, std::allocator, uint32_t, void> inner_spec_type;
+	typedef asm_lsw::map_adaptor_phf <inner_spec_type> inner_adaptor_type;
+	typedef asm_lsw::map_adaptor_phf_spec <std::vector, std::allocator, uint32_t, inner_adaptor_type> outer_spec_type;
+	typedef asm_lsw::map_adaptor_phf <outer_spec_type> outer_adaptor_type;
+	typedef std::map <uint32_t, std::vector <uint32_t>> outer_map_type;
+	
+	struct transform_value
+	{
+		outer_adaptor_type::kv_type operator()(outer_map_type::value_type &kv) const
+		{
+			inner_adaptor_type adaptor(kv.second);
+			return std::make_pair(kv.first, std::move(adaptor));
+		}
+	};
+	
+	
+	double run_serial(outer_map_type const &values)
+	{
+		outer_map_type values_copy(values);
+		auto const start(clock_type::now());
+		outer_adaptor_type::builder_type <outer_map_type, transform_value> builder(values_copy);
+		outer_adaptor_type adaptor(builder);
+		return seconds_since(start);
+	}
+	
+	
+	double run_parallel(outer_map_type const &values, std::size_t const thread_count)
+	{
+		outer_map_type values_copy(values);
+		auto const start(clock_type::now());
+		outer_adaptor_type::parallel_builder_type <outer_map_type, transform_value> builder(values_copy, thread_count);
+		outer_adaptor_type adaptor(builder.builder());
+		return seconds_since(start);
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	std::size_t const key_count(1 < argc ? std::strtoull(argv[1], nullptr, 10) : 1000000);
+	std::size_t const map_count(2 < argc ? std::strtoull(argv[2], nullptr, 10) : 10000);
+	std::size_t const max_threads(3 < argc ? std::strtoull(argv[3], nullptr, 10) : std::thread::hardware_concurrency());
+	
+	{
+		auto const keys(random_keys(key_count, 0));
+		map_type values;
+		for (auto const key : keys)
+			values.emplace(key, key);
+		
+		// Query the stored keys in random order as well as keys that are not likely to be found.
+		std::vector <uint32_t> queries(keys);
+		auto const misses(random_keys(key_count, 1));
+		queries.insert(queries.end(), misses.cbegin(), misses.cend());
+		std::shuffle(queries.begin(), queries.end(), std::mt19937(2));
+		
+		std::cout << "lambda\talpha\tbuild_seconds\tns_per_lookup\tbytes_per_key\tfound" << std::endl;
+		run_parameters <1, 80>(values, queries);
+		run_parameters <2, 80>(values, queries);
+		run_parameters <4, 80>(values, queries);
+		run_parameters <4, 90>(values, queries);
+		run_parameters <4, 99>(values, queries);
+		run_parameters <6, 80>(values, queries);
+		run_parameters <8, 95>(values, queries);
+	}
+	
+	{
+		// Many small maps with about 100 keys each.
+		auto const keys(random_keys(100 * map_count, 3));
+		outer_map_type values;
+		for (std::size_t i(0); i < keys.size(); ++i)
+			values[i % map_count].push_back(keys[i]);
+		
+		for (auto &kv : values)
+		{
+			auto &vec(kv.second);
+			std::sort(vec.begin(), vec.end());
+			vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+		}
+		
+		std::cout << std::endl << "threads\tbuild_seconds" << std::endl;
+		std::cout << "serial\t" << run_serial(values) << std::endl;
+		for (std::size_t threads(1); threads <= max_threads; threads *= 2)
+			std::cout << threads << '\t' << run_parallel(values, threads) << std::endl;
+	}
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/util.hh>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+// Compare the binary search with the batched one that prefetches the next two levels.
+// Each probe reads a random position of one array and uses the value to index another one,
+// similarly to the SA and ISA accesses in k1_matcher::find_pattern_occurrence. As there, the
+// batched search does the first access for the next two levels and prefetches the second one.
+// Usage: search_monotone_benchmark [size] [query_count] [rounds]
+// Prints one tab-separated line per search.
+
+namespace {
+	
+	typedef std::chrono::steady_clock clock_type;
+	typedef asm_lsw::util::search_direction search_direction;
+	
+	
+	double seconds_since(clock_type::time_point const start)
+	{
+		std::chrono::duration <double> const elapsed(clock_type::now() - start);
+		return elapsed.count();
+	}
+	
+	
+	struct indirect_values
+	{
+		std::vector <uint64_t> positions;	// Stands in for the SA samples.
+		std::vector <uint64_t> values;		// Stands in for the ISA samples.
+		
+		indirect_values(std::size_t const size, uint32_t const seed):
+			positions(size),
+			values(size)
+		{
+			// Store the increasing values 2i + 1 in a random order.
+			std::iota(positions.begin(), positions.end(), 0);
+			std::shuffle(positions.begin(), positions.end(), std::mt19937(seed));
+			for (std::size_t i(0); i < size; ++i)
+				values[positions[i]] = 2 * i + 1;
+		}
+		
+		search_direction probe(uint64_t const mid, uint64_t const val) const
+		{
+			auto const res(values[positions[mid]]);
+			if (res < val)
+				return search_direction::right;
+			if (val < res)
+				return search_direction::left;
+			return search_direction::found;
+		}
+		
+		void prefetch(uint64_t const j) const
+		{
+			asm_lsw::util::prefetch(&values[positions[j]]);
+		}
+	};
+	
+	
+	template <typename t_search_fn>
+	void run_search(char const *name, std::vector <uint64_t> const &queries, std::size_t const rounds, t_search_fn &&search_fn)
+	{
+		double best(0);
+		std::size_t found(0);
+		for (std::size_t round(0); round < rounds; ++round)
+		{
+			found = 0;
+			auto const start(clock_type::now());
+			for (auto const val : queries)
+			{
+				if (search_fn(val))
+					++found;
+			}
+			auto const seconds(seconds_since(start));
+			if (0 == round || seconds < best)
+				best = seconds;
+		}
+		
+		std::cout << name << '\t' << (1e9 * best / queries.size()) << '\t' << found << std::endl;
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	std::size_t const size(1 < argc ? std::strtoull(argv[1], nullptr, 10) : (std::size_t(1) << 25));
+	std::size_t const query_count(2 < argc ? std::strtoull(argv[2], nullptr, 10) : 1000000);
+	std::size_t const rounds(3 < argc ? std::strtoull(argv[3], nullptr, 10) : 3);
+	
+	if (0 == size)
+	{
+		std::cerr << "The size must be positive." << std::endl;
+		return EXIT_FAILURE;
+	}
+	
+	indirect_values const iv(size, 0);
+	
+	// Search for both present (odd) and missing (even) values.
+	std::mt19937 gen(1);
+	std::uniform_int_distribution <uint64_t> dist(0, 2 * size);
+	std::vector <uint64_t> queries(query_count);
+	for (auto &val : queries)
+		val = dist(gen);
+	
+	std::cout << "search\tns_per_query\tfound" << std::endl;
+	run_search("binary", queries, rounds, [&iv, size](uint64_t const val){
+		uint64_t idx(0);
+		return asm_lsw::util::search_monotone(uint64_t(0), uint64_t(size - 1), idx, [&iv, val](uint64_t const mid){
+			return iv.probe(mid, val);
+		});
+	});
+	run_search("batched", queries, rounds, [&iv, size](uint64_t const val){
+		uint64_t idx(0);
+		return asm_lsw::util::search_monotone_batched(uint64_t(0), uint64_t(size - 1), idx, [&iv](uint64_t const j){
+			iv.prefetch(j);
+		}, [&iv, val](uint64_t const mid){
+			return iv.probe(mid, val);
+		});
+	});
+	
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#ifndef ASM_LSW_ALPHABET_HH
+#define ASM_LSW_ALPHABET_HH
+
+
+namespace asm_lsw {
+	
+	// The characters of the CST's alphabet, read from comp2char.
+	struct generic_alphabet
+	{
+		// Call fn with each character, including the sentinel, until it returns true.
+		// Return true if fn did.
+		template <typename t_cst, typename t_fn>
+		static bool for_each_char(t_cst const &cst, t_fn &&fn)
+		{
+			for (typename t_cst::sigma_type c(0); c < cst.csa.sigma; ++c)
+			{
+				if (fn(cst.csa.comp2char[c]))
+					return true;
+			}
+			return false;
+		}
+	};
+	
+	
+	// The alphabet that k1_matcher uses for the given pattern type.
+	template <typename t_pattern>
+	struct pattern_alphabet
+	{
+		typedef generic_alphabet type;
+	};
+}
+
+#endif
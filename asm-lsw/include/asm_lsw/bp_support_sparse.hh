@@ -23,6 +23,7 @@
 #include <boost/format.hpp>
 #include <cstdint>
 #include <cstdio>
+#include <sdsl/bit_vector_il.hpp>
 #include <sdsl/bp_support.hpp>
 
 
@@ -59,9 +60,11 @@ namespace asm_lsw {
 	
 	
 	// A bps class for sparse sequences i.e. ones that may contain spaces in addition to () characters.
+	// Each query translates the position with the mask's rank and select support, so the layout of
+	// the mask determines most of the cache misses in addition to the ones caused by t_bps.
 	template <
 		typename t_bps		= sdsl::bp_support_g<>,
-		typename t_vector	= sdsl::bit_vector			// Unfortunately select is needed, otherwise rrr_vector might be preferrable.
+		typename t_vector	= sdsl::bit_vector			// Needs rank and select support and a constructor from sdsl::bit_vector, e.g. sdsl::sd_vector.
 	>
 	class bp_support_sparse : public bp_support_sparse_base<t_vector>
 	{
@@ -187,11 +190,11 @@ namespace asm_lsw {
 		size_type to_sparse_idx(typename bp_type::size_type const idx) const;
 		size_type find_open(size_type i) const;
 		size_type find_close(size_type i) const;
+		size_type enclose(size_type i) const;
 		size_type rank(size_type i) const;
 		size_type select(size_type i) const;
 
 		// TODO: implement rmq_open
-		// TODO: implement enclose
 		// TODO: implement rr_enclose
 		// TODO: implement double_enclose
 		
@@ -200,6 +203,12 @@ namespace asm_lsw {
 	};
 	
 	
+	// Stores the rank samples of the mask in the same cache lines as the bits, so that
+	// translating a sparse position to a dense one takes one cache miss.
+	template <typename t_bps = sdsl::bp_support_g <>>
+	using bp_support_sparse_il = bp_support_sparse <t_bps, sdsl::bit_vector_il <>>;
+	
+	
 	template <typename t_bps, typename t_vector>
 	template <typename t_int_vector>
 	void bp_support_sparse <t_bps, t_vector>::fill_int_vector(t_int_vector &dst, char const *src)
@@ -397,7 +406,11 @@ namespace asm_lsw {
 			
 			// Update instance variables.
 			this->m_bp = std::move(bp);
-			this->m_mask = std::move(mask);
+			
+			{
+				t_vector tmp(std::move(mask));
+				this->m_mask = std::move(tmp);
+			}
 		}
 		
 		// Update more instance variables.
@@ -474,6 +487,25 @@ namespace asm_lsw {
 	}
 
 	
+	// Returns the opening parenthesis of the pair that encloses the one at i or size() if there is none.
+	template <typename t_bps, typename t_vector>
+	auto bp_support_sparse <t_bps, t_vector>::enclose(size_type i) const -> size_type
+	{
+		asm_lsw_assert(i < this->m_mask.size(), std::invalid_argument, error::out_of_range);
+		asm_lsw_assert(1 == this->m_mask[i], std::invalid_argument, error::sparse_index);
+		
+		auto bp_begin(to_bp_idx(i));
+		asm_lsw_assert(1 == this->m_bp[bp_begin], std::invalid_argument, error::bad_parenthesis);
+		
+		auto bp_enclosing(m_bps.enclose(bp_begin));
+		if (this->m_bp.size() == bp_enclosing)
+			return size();
+		
+		auto retval(to_sparse_idx(bp_enclosing));
+		return retval;
+	}
+	
+	
 	template <typename t_bps, typename t_vector>
 	auto bp_support_sparse <t_bps, t_vector>::rank(size_type i) const -> size_type
 	{
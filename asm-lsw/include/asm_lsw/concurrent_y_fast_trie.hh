@@ -0,0 +1,361 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+
+#ifndef ASM_LSW_CONCURRENT_Y_FAST_TRIE_HH
+#define ASM_LSW_CONCURRENT_Y_FAST_TRIE_HH
+
+#include <asm_lsw/x_fast_trie.hh>
+#include <asm_lsw/y_fast_trie.hh>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+
+namespace asm_lsw {
+	
+	// Mutable Y-fast trie that may be queried by multiple threads while it is being modified.
+	// The key space is split into 2^t_shard_bits ranges by the most significant bits. Each range
+	// has a private y_fast_trie that is modified under the range's mutex and an immutable snapshot
+	// of it that readers use. Publishing copies the shard's trie, so in order to keep the copying
+	// cost amortized constant per modification, the snapshot is replaced (RCU-style) only after
+	// max(publish_interval, shard size / s_publish_size_divisor) modifications to the shard or
+	// when synchronize() is called. Until then the readers do not see at most that many of the
+	// latest modifications of each shard. The staleness is bounded only by the number of
+	// modifications, not by time, so a shard that is modified rarely may stay stale indefinitely.
+	// This also applies to the writing thread, i.e. a thread does not see its own modifications
+	// before they have been published; call synchronize() (or synchronize(key) for a single
+	// shard) to make them visible. Readers only copy a shared_ptr and never wait for the
+	// writers. Since iterators would be invalidated when a snapshot is released, the queries
+	// return keys and values instead.
+	template <typename t_key, typename t_value = void, std::size_t t_shard_bits = 6>
+	class concurrent_y_fast_trie
+	{
+		static_assert(t_shard_bits < std::numeric_limits <t_key>::digits, "Too many shard bits for the key type.");
+	
+	public:
+		typedef y_fast_trie <t_key, t_value> trie_type;
+		typedef typename trie_type::key_type key_type;
+		typedef typename trie_type::value_type value_type;
+		typedef typename trie_type::size_type size_type;
+		typedef typename trie_type::const_subtree_iterator const_subtree_iterator;
+		
+		static std::size_t const s_shard_count{std::size_t(1) << t_shard_bits};
+		static std::size_t const s_shard_shift{std::numeric_limits <key_type>::digits - t_shard_bits};
+		static std::size_t const s_default_publish_interval{64};
+		static std::size_t const s_publish_size_divisor{16};
+	
+	protected:
+		typedef std::shared_ptr <trie_type const> snapshot_ptr;
+		
+		struct shard
+		{
+			std::mutex mutex;				// Serializes the writers.
+			trie_type trie;					// Written only while holding mutex.
+			snapshot_ptr snapshot;			// Accessed with std::atomic_load and std::atomic_store.
+			size_type pending_count{0};		// Modifications not yet visible in snapshot.
+		};
+	
+	protected:
+		std::array <shard, s_shard_count> m_shards;
+		size_type m_publish_interval{s_default_publish_interval};
+	
+	protected:
+		static std::size_t shard_idx(key_type const key) { return key >> s_shard_shift; }
+		snapshot_ptr snapshot(std::size_t const idx) const { return std::atomic_load(&m_shards[idx].snapshot); }
+		void publish(shard &shard);
+		void did_modify(shard &shard);
+	
+	public:
+		concurrent_y_fast_trie(): concurrent_y_fast_trie(std::numeric_limits <key_type>::max()) {}
+		concurrent_y_fast_trie(key_type const key_limit, size_type const publish_interval = s_default_publish_interval);
+		concurrent_y_fast_trie(concurrent_y_fast_trie const &) = delete;
+		concurrent_y_fast_trie &operator=(concurrent_y_fast_trie const &) & = delete;
+		
+		size_type publish_interval() const { return m_publish_interval; }
+		
+		// Conditionally enable either. Return false if the key was already present, in which
+		// case the existing value is kept (like std::map::insert).
+		template <typename T = value_type>
+		typename std::enable_if <std::is_void <T>::value, bool>::type
+		insert(key_type const key);
+		
+		template <typename T = value_type>
+		bool insert(key_type const key, typename std::enable_if <!std::is_void <T>::value, T>::type const val);
+		
+		// Replace the value if the key is present. Return true if the key was inserted.
+		template <typename T = value_type>
+		bool insert_or_assign(key_type const key, typename std::enable_if <!std::is_void <T>::value, T>::type const val);
+		
+		bool erase(key_type const key);
+		
+		// Make all the modifications visible to the readers.
+		void synchronize();
+		
+		// Make the modifications of the shard of the given key visible to the readers.
+		void synchronize(key_type const key);
+		
+		// The queries operate on the published snapshots.
+		size_type size() const;
+		bool contains(key_type const key) const;
+		
+		template <typename T = value_type>
+		auto find(key_type const key, T &val) const -> typename std::enable_if <!std::is_void <T>::value, bool>::type;
+		
+		bool find_predecessor(key_type const key, key_type &pred, bool allow_equal = false) const;
+		bool find_successor(key_type const key, key_type &succ, bool allow_equal = false) const;
+	};
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::concurrent_y_fast_trie(
+		key_type const key_limit,
+		size_type const publish_interval
+	):
+		m_publish_interval(publish_interval ? publish_interval : 1)
+	{
+		for (auto &shard : m_shards)
+		{
+			trie_type trie(key_limit);
+			shard.trie = std::move(trie);
+			std::atomic_store(&shard.snapshot, snapshot_ptr(new trie_type(shard.trie)));
+		}
+	}
+	
+	
+	// Replace the snapshot with a copy of the current trie. The previous snapshot
+	// is released when the last reader drops its reference to it.
+	// Needs to be called while holding shard.mutex.
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	void concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::publish(shard &shard)
+	{
+		snapshot_ptr ptr(new trie_type(shard.trie));
+		std::atomic_store(&shard.snapshot, std::move(ptr));
+		shard.pending_count = 0;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	void concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::did_modify(shard &shard)
+	{
+		// Publishing copies shard.trie, so let the interval grow with the shard.
+		size_type const size_limit(shard.trie.size() / s_publish_size_divisor);
+		if (std::max(m_publish_interval, size_limit) <= ++shard.pending_count)
+			publish(shard);
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	template <typename T>
+	typename std::enable_if <std::is_void <T>::value, bool>::type
+	concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::insert(key_type const key)
+	{
+		auto &shard(m_shards[shard_idx(key)]);
+		std::lock_guard <std::mutex> lock(shard.mutex);
+		
+		// y_fast_trie counts duplicate insertions.
+		if (shard.trie.contains(key))
+			return false;
+		
+		shard.trie.insert(key);
+		did_modify(shard);
+		return true;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	template <typename T>
+	void concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::insert(
+		key_type const key,
+		typename std::enable_if <!std::is_void <T>::value, T>::type const val
+	)
+	{
+		auto &shard(m_shards[shard_idx(key)]);
+		std::lock_guard <std::mutex> lock(shard.mutex);
+		
+		if (shard.trie.contains(key))
+			return false;
+		
+		shard.trie.insert(key, val);
+		did_modify(shard);
+		return true;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	template <typename T>
+	bool concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::insert_or_assign(
+		key_type const key,
+		typename std::enable_if <!std::is_void <T>::value, T>::type const val
+	)
+	{
+		auto &shard(m_shards[shard_idx(key)]);
+		std::lock_guard <std::mutex> lock(shard.mutex);
+		
+		// y_fast_trie has no mutable access to the values.
+		bool const is_present(shard.trie.erase(key));
+		shard.trie.insert(key, val);
+		did_modify(shard);
+		return !is_present;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	bool concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::erase(key_type const key)
+	{
+		auto &shard(m_shards[shard_idx(key)]);
+		std::lock_guard <std::mutex> lock(shard.mutex);
+		
+		if (!shard.trie.erase(key))
+			return false;
+		
+		did_modify(shard);
+		return true;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	void concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::synchronize()
+	{
+		for (auto &shard : m_shards)
+		{
+			std::lock_guard <std::mutex> lock(shard.mutex);
+			if (shard.pending_count)
+				publish(shard);
+		}
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	void concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::synchronize(key_type const key)
+	{
+		auto &shard(m_shards[shard_idx(key)]);
+		std::lock_guard <std::mutex> lock(shard.mutex);
+		if (shard.pending_count)
+			publish(shard);
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	auto concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::size() const -> size_type
+	{
+		size_type retval(0);
+		for (std::size_t i(0); i < s_shard_count; ++i)
+			retval += snapshot(i)->size();
+		return retval;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	bool concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::contains(key_type const key) const
+	{
+		auto const ptr(snapshot(shard_idx(key)));
+		return ptr->contains(key);
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	template <typename T>
+	auto concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::find(
+		key_type const key,
+		T &val
+	) const -> typename std::enable_if <!std::is_void <T>::value, bool>::type
+	{
+		auto const ptr(snapshot(shard_idx(key)));
+		const_subtree_iterator it;
+		if (!ptr->find(key, it))
+			return false;
+		
+		val = ptr->iterator_value(it);
+		return true;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	bool concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::find_predecessor(
+		key_type const key,
+		key_type &pred,
+		bool allow_equal
+	) const
+	{
+		auto idx(shard_idx(key));
+		
+		{
+			auto const ptr(snapshot(idx));
+			const_subtree_iterator it;
+			if (ptr->find_predecessor(key, it, allow_equal))
+			{
+				pred = ptr->iterator_key(it);
+				return true;
+			}
+		}
+		
+		// The predecessor is the maximum of the nearest non-empty shard on the left.
+		while (idx)
+		{
+			--idx;
+			auto const ptr(snapshot(idx));
+			if (ptr->size())
+			{
+				pred = ptr->max_key();
+				return true;
+			}
+		}
+		
+		return false;
+	}
+	
+	
+	template <typename t_key, typename t_value, std::size_t t_shard_bits>
+	bool concurrent_y_fast_trie <t_key, t_value, t_shard_bits>::find_successor(
+		key_type const key,
+		key_type &succ,
+		bool allow_equal
+	) const
+	{
+		auto idx(shard_idx(key));
+		
+		{
+			auto const ptr(snapshot(idx));
+			const_subtree_iterator it;
+			if (ptr->find_successor(key, it, allow_equal))
+			{
+				succ = ptr->iterator_key(it);
+				return true;
+			}
+		}
+		
+		// The successor is the minimum of the nearest non-empty shard on the right.
+		while (++idx < s_shard_count)
+		{
+			auto const ptr(snapshot(idx));
+			if (ptr->size())
+			{
+				succ = ptr->min_key();
+				return true;
+			}
+		}
+		
+		return false;
+	}
+}
+
+#endif
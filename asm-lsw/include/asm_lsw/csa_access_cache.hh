@@ -0,0 +1,212 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#ifndef ASM_LSW_CSA_ACCESS_CACHE_HH
+#define ASM_LSW_CSA_ACCESS_CACHE_HH
+
+#include <asm_lsw/util.hh>
+#include <array>
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+
+namespace asm_lsw { namespace detail {
+	
+	// Prefetch the ISA sample that the CSA reads first when locating a value.
+	// Only done for CSAs that store their samples in int_vectors like SDSL's
+	// csa_sada and csa_wt; for the others this does nothing.
+	template <typename t_csa, typename t_enable = void>
+	struct csa_sample_prefetch
+	{
+		static void isa(t_csa const &csa, std::size_t const idx) {}
+	};
+	
+	template <typename t_csa>
+	struct csa_sample_prefetch <
+		t_csa,
+		typename util::enable_if_type <
+			decltype(
+				std::declval <t_csa const &>().isa_sample.data(),
+				std::declval <t_csa const &>().isa_sample.width(),
+				t_csa::isa_sample_dens
+			)
+		>::type
+	>
+	{
+		static void isa(t_csa const &csa, std::size_t const idx)
+		{
+			auto const &samples(csa.isa_sample);
+			auto const sample_idx(idx / t_csa::isa_sample_dens);
+			if (sample_idx < samples.size())
+				util::prefetch(samples.data() + sample_idx * samples.width() / 64);
+		}
+	};
+}}
+
+
+namespace asm_lsw {
+	
+	// Direct-mapped cache of SA and ISA values for the queries of one thread.
+	// Locating a value in a sampled CSA walks the psi or LF function until a sample
+	// is found, and the k = 1 search reads the same indices repeatedly for a pattern.
+	// The cache is bound to an owner (e.g. a matcher) and a CSA and cleared only when
+	// either changes, so the values are kept from one query to the next. Since the values
+	// only depend on the CSA, they stay valid; clearing the cache for every query would
+	// cost more than the misses it avoids for short patterns.
+	template <typename t_csa, std::size_t t_size_bits = 10>
+	class csa_access_cache
+	{
+	public:
+		typedef typename t_csa::size_type	size_type;
+		
+		struct statistics_type
+		{
+			size_type sa_hits{0};
+			size_type sa_misses{0};
+			size_type isa_hits{0};
+			size_type isa_misses{0};
+		};
+		
+		static std::size_t const s_size{std::size_t(1) << t_size_bits};
+		static size_type const s_invalid_key{std::numeric_limits <size_type>::max()};
+		
+	protected:
+		struct entry
+		{
+			size_type key{s_invalid_key};
+			size_type value{0};
+		};
+		
+		typedef std::array <entry, s_size> entry_array;
+		
+	protected:
+		entry_array			m_sa;
+		entry_array			m_isa;
+		t_csa const			*m_csa{nullptr};
+		std::size_t			m_owner{0};
+		statistics_type		m_statistics;
+		
+	protected:
+		template <typename t_fn>
+		size_type find(entry_array &entries, size_type const idx, size_type &hits, size_type &misses, t_fn &&fn);
+		
+	public:
+		// Return a new identifier for an owner of the cached values.
+		static std::size_t next_owner_id();
+		
+		// Use the given CSA. Clear the cache if the owner or the CSA changed.
+		void bind(t_csa const &csa, std::size_t const owner);
+		void clear();
+		
+		size_type sa(size_type const idx);
+		size_type isa(size_type const idx);
+		
+		// Prefetch the first ISA sample that isa(idx) will read unless the value is cached.
+		void prefetch_isa(size_type const idx) const;
+		
+		statistics_type const &statistics() const { return m_statistics; }
+		void reset_statistics() { m_statistics = statistics_type(); }
+	};
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	std::size_t csa_access_cache <t_csa, t_size_bits>::next_owner_id()
+	{
+		static std::atomic <std::size_t> s_next_id{1};
+		return s_next_id++;
+	}
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	void csa_access_cache <t_csa, t_size_bits>::bind(t_csa const &csa, std::size_t const owner)
+	{
+		if (&csa != m_csa || owner != m_owner)
+		{
+			clear();
+			m_csa = &csa;
+			m_owner = owner;
+		}
+	}
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	void csa_access_cache <t_csa, t_size_bits>::clear()
+	{
+		m_sa.fill(entry());
+		m_isa.fill(entry());
+	}
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	template <typename t_fn>
+	auto csa_access_cache <t_csa, t_size_bits>::find(
+		entry_array &entries,
+		size_type const idx,
+		size_type &hits,
+		size_type &misses,
+		t_fn &&fn
+	) -> size_type
+	{
+		auto &entry(entries[idx & (s_size - 1)]);
+		if (idx == entry.key)
+		{
+			++hits;
+			return entry.value;
+		}
+		
+		++misses;
+		entry.key = idx;
+		entry.value = fn(idx);
+		return entry.value;
+	}
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	auto csa_access_cache <t_csa, t_size_bits>::sa(size_type const idx) -> size_type
+	{
+		assert(m_csa);
+		auto const &csa(*m_csa);
+		return find(m_sa, idx, m_statistics.sa_hits, m_statistics.sa_misses, [&csa](size_type const i) -> size_type {
+			return csa[i];
+		});
+	}
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	void csa_access_cache <t_csa, t_size_bits>::prefetch_isa(size_type const idx) const
+	{
+		assert(m_csa);
+		auto const &entry(m_isa[idx & (s_size - 1)]);
+		if (idx != entry.key)
+			detail::csa_sample_prefetch <t_csa>::isa(*m_csa, idx);
+	}
+	
+	
+	template <typename t_csa, std::size_t t_size_bits>
+	auto csa_access_cache <t_csa, t_size_bits>::isa(size_type const idx) -> size_type
+	{
+		assert(m_csa);
+		auto const &isa(m_csa->isa);
+		return find(m_isa, idx, m_statistics.isa_hits, m_statistics.isa_misses, [&isa](size_type const i) -> size_type {
+			return isa[i];
+		});
+	}
+}
+
+#endif
@@ -18,6 +18,7 @@
 #ifndef ASM_LSW_CST_EDGE_PATTERN_PAIR_HH
 #define ASM_LSW_CST_EDGE_PATTERN_PAIR_HH
 
+#include <asm_lsw/alphabet.hh>
 #include <asm_lsw/cst_edge_adaptor.hh>
 #include <asm_lsw/util.hh>
 #include <vector>
@@ -136,6 +137,14 @@ namespace asm_lsw {
 	};
 	
 	
+	// The path label is followed by the rest of the pattern, so use the pattern's alphabet.
+	template <typename t_cst, typename t_pattern>
+	struct pattern_alphabet <cst_edge_pattern_pair <t_cst, t_pattern>>
+	{
+		typedef typename pattern_alphabet <t_pattern>::type type;
+	};
+	
+	
 	template <typename t_cst, typename t_pattern>
 	auto cst_edge_pattern_pair <t_cst, t_pattern>::operator[](size_type i) const -> value_type
 	{
@@ -0,0 +1,136 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#ifndef ASM_LSW_DNA_PATTERN_HH
+#define ASM_LSW_DNA_PATTERN_HH
+
+#include <asm_lsw/alphabet.hh>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace asm_lsw {
+	
+	// Handling of IUPAC N (and the other ambiguity codes) in the reads.
+	enum class dna_n_policy : uint8_t
+	{
+		mismatch,	// N does not match any character, i.e. each N costs one difference.
+		reject		// Reads that contain N are not aligned.
+	};
+	
+	
+	// Nucleotide alphabet. The characters tried in substitutions and insertions are the sentinel
+	// and A, C, G and T, so they may be enumerated without reading comp2char. Other symbols in
+	// the text, e.g. N, are never tried, so they do not match any character of a read, not even
+	// as a substitution.
+	struct dna_alphabet
+	{
+		// N and the other ambiguity codes are replaced with a character that does not occur in
+		// the text, so that they do not match anything, not even an N in the reference.
+		static char const n_char{'\xff'};
+		
+		// Call fn with each character, including the sentinel, until it returns true.
+		// Return true if fn did.
+		template <typename t_cst, typename t_fn>
+		static bool for_each_char(t_cst const &cst, t_fn &&fn)
+		{
+			typedef typename t_cst::char_type char_type;
+			return (
+				fn(char_type(0)) ||
+				fn(char_type('A')) ||
+				fn(char_type('C')) ||
+				fn(char_type('G')) ||
+				fn(char_type('T'))
+			);
+		}
+		
+		// Convert the bases to upper case and replace the other characters with n_char in place.
+		// Return the number of the replaced characters.
+		template <typename t_sequence>
+		static std::size_t normalize(t_sequence &seq);
+	};
+	
+	
+	// A read normalized with dna_alphabet::normalize(). The pattern refers to the characters of
+	// the sequence, which needs to outlive it. The type selects dna_alphabet in the matchers.
+	class dna_pattern
+	{
+	public:
+		typedef std::size_t		size_type;
+		typedef char			value_type;
+		typedef char const *	const_iterator;
+		
+	protected:
+		char const	*m_data{nullptr};
+		size_type	m_size{0};
+		
+	public:
+		dna_pattern() {}
+		
+		template <typename t_sequence>
+		explicit dna_pattern(t_sequence const &seq):
+			m_data(seq.data()),
+			m_size(seq.size())
+		{
+		}
+		
+		size_type size() const { return m_size; }
+		value_type operator[](size_type const i) const { return m_data[i]; }
+		
+		const_iterator cbegin() const	{ return m_data; }
+		const_iterator cend() const		{ return m_data + m_size; }
+	};
+	
+	
+	template <>
+	struct pattern_alphabet <dna_pattern>
+	{
+		typedef dna_alphabet type;
+	};
+	
+	
+	template <typename t_sequence>
+	std::size_t dna_alphabet::normalize(t_sequence &seq)
+	{
+		std::size_t n_count(0);
+		for (auto &c : seq)
+		{
+			switch (c)
+			{
+				case 'A':
+				case 'C':
+				case 'G':
+				case 'T':
+					break;
+					
+				case 'a':
+				case 'c':
+				case 'g':
+				case 't':
+					c -= 'a' - 'A';
+					break;
+					
+				default:
+					c = n_char;
+					++n_count;
+					break;
+			}
+		}
+		return n_count;
+	}
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include <asm_lsw/map_adaptor_helper.hh>
 #include <asm_lsw/map_adaptor_phf.hh>
 #include <asm_lsw/pool_allocator.hh>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -53,9 +54,20 @@ namespace asm_lsw {
 	
 	
 
-	template <typename t_key, typename t_value, bool t_enable_serialize = false, typename t_access_key = map_adaptor_access_key <t_key>>
+	// If t_minimal_hash is true, the slots are compressed, see map_adaptor_mphf_spec.
+	template <
+		typename t_key,
+		typename t_value,
+		bool t_enable_serialize = false,
+		typename t_access_key = map_adaptor_access_key <t_key>,
+		bool t_minimal_hash = false
+	>
 	using fast_trie_compact_map_adaptor = map_adaptor_phf <
-		map_adaptor_phf_spec <std::vector, pool_allocator, t_key, t_value, t_enable_serialize, t_access_key>
+		typename std::conditional <
+			t_minimal_hash,
+			map_adaptor_mphf_spec <std::vector, pool_allocator, t_key, t_value, t_enable_serialize, t_access_key>,
+			map_adaptor_phf_spec <std::vector, pool_allocator, t_key, t_value, t_enable_serialize, t_access_key>
+		>::type
 	>;
 }
 	
@@ -18,6 +18,7 @@
 #define ASM_LSW_FAST_TRIE_COMPACT_AS_HELPER_HH
 
 #include <functional>
+#include <limits>
 #include <sdsl/io.hpp>
 
 
@@ -45,6 +46,46 @@ namespace asm_lsw { namespace detail {
 	};
 	
 	
+	template <typename t_key, typename t_value>
+	struct fast_trie_compact_as_range_trait
+	{
+		typedef std::function <void(t_key, t_value const &)> range_callback_type;
+	};
+	
+	
+	template <typename t_key>
+	struct fast_trie_compact_as_range_trait <t_key, void>
+	{
+		typedef std::function <void(t_key)> range_callback_type;
+	};
+	
+	
+	// Convert the closed range [lo, hi] to the key space of a trie with the given offset.
+	// Returns false if the ranges do not intersect.
+	template <typename t_key, typename t_trie_key>
+	bool fast_trie_compact_as_adapt_range(
+		t_key const offset,
+		t_key const lo,
+		t_key const hi,
+		t_trie_key &trie_lo,
+		t_trie_key &trie_hi
+	)
+	{
+		if (hi < lo || hi < offset)
+			return false;
+		
+		t_key const max(std::numeric_limits <t_trie_key>::max());
+		t_key const lo_(lo < offset ? 0 : lo - offset);
+		if (max < lo_)
+			return false;
+		
+		t_key const hi_(hi - offset);
+		trie_lo = lo_;
+		trie_hi = (max < hi_ ? max : hi_);
+		return true;
+	}
+	
+	
 	template <typename t_value>
 	struct fast_trie_compact_as_tpl_value_trait
 	{
@@ -140,6 +140,91 @@ namespace asm_lsw {
 			cb.finish();
 		}
 	};
+	
+	
+	// Pass the sequences to the callback one line at a time instead of collecting them
+	// into vectors, so that the memory use does not depend on the sequence length.
+	// Lines longer than the buffer are passed in several chunks.
+	// The callback needs to have begin_sequence(identifier), handle_chunk(data, size),
+	// end_sequence() and finish().
+	template <typename t_callback, std::size_t t_buffer_size = 1024 * 1024>
+	class fasta_chunk_reader
+	{
+	public:
+		void read_from_stream(std::istream &stream, t_callback &cb) const
+		{
+			static_assert(1 < t_buffer_size, "The buffer needs space for at least one character.");
+			std::vector <char> buffer(t_buffer_size, '\0');
+			std::string identifier;
+			bool in_sequence(false);
+			bool in_header(false);
+			bool in_comment(false);
+			bool continues_line(false);
+			
+			while (true)
+			{
+				stream.getline(buffer.data(), t_buffer_size, '\n');
+				
+				// If the line does not fit into the buffer, failbit is set without eofbit.
+				// Clear it and handle the rest of the line on the next iteration.
+				bool const is_partial(stream.fail() && !stream.eof());
+				if (is_partial)
+					stream.clear();
+				else if (!stream)
+					break;
+				
+				// Delimiter is counted in gcount unless the line was partial or not terminated.
+				std::streamsize const count(stream.gcount() - (is_partial || stream.eof() ? 0 : 1));
+				
+				if (!continues_line)
+				{
+					auto const first(buffer[0]);
+					in_comment = (';' == first);
+					in_header = ('>' == first);
+					if (in_header)
+					{
+						if (in_sequence)
+							cb.end_sequence();
+						
+						in_sequence = false;
+						identifier.assign(1 + buffer.data(), count - 1);
+					}
+				}
+				else if (in_header)
+				{
+					identifier.append(buffer.data(), count);
+				}
+				continues_line = is_partial;
+				
+				// Discard comments.
+				if (in_comment)
+					continue;
+				
+				if (in_header)
+				{
+					if (!continues_line)
+					{
+						cb.begin_sequence(identifier);
+						in_sequence = true;
+					}
+					continue;
+				}
+				
+				if (!in_sequence)
+				{
+					cb.begin_sequence(std::string());
+					in_sequence = true;
+				}
+				
+				cb.handle_chunk(buffer.data(), count);
+			}
+			
+			if (in_sequence)
+				cb.end_sequence();
+			
+			cb.finish();
+		}
+	};
 }
 
 #endif
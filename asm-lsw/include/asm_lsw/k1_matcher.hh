@@ -17,15 +17,21 @@
 #ifndef ASM_LSW_K1_MATCHER_HH
 #define ASM_LSW_K1_MATCHER_HH
 
+#include <asm_lsw/alphabet.hh>
 #include <asm_lsw/bp_support_sparse.hh>
+#include <asm_lsw/csa_access_cache.hh>
 #include <asm_lsw/fast_trie_as_ptr.hh>
+#include <asm_lsw/pool_allocator.hh>
 #include <asm_lsw/x_fast_tries.hh>
 #include <asm_lsw/y_fast_tries.hh>
+#include <memory>
 #include <sdsl/csa_rao.hpp>
 #include <sdsl/cst_sada.hpp>
 #include <sdsl/int_vector.hpp>
 #include <sdsl/isa_lsw.hpp>
+#include <sdsl/sd_vector.hpp>
 #include <set>
+#include <vector>
 
 
 namespace asm_lsw {
@@ -65,7 +71,7 @@ namespace asm_lsw {
 		
 		// Indexed by identifiers from node_id().
 		typedef sdsl::bit_vector										core_nodes_type;
-		typedef bp_support_sparse <>									core_endpoints_type;	// FIXME: check parameters.
+		typedef bp_support_sparse <sdsl::bp_support_g <>, sdsl::sd_vector <>>	core_endpoints_type;	// The endpoints are sparse.
 		
 		typedef sdsl::rmq_succinct_sct <>								lcp_rmq_type;			// Default parameters. FIXME: check that they yield O(t_SA) time complexity.
 		
@@ -74,6 +80,8 @@ namespace asm_lsw {
 			typename csa_type::size_type
 		>																csa_range;
 		typedef std::vector <csa_range>									csa_ranges;
+		
+		typedef csa_access_cache <csa_type>								csa_cache_type;
 
 		static_assert(
 			std::is_unsigned <typename cst_type::node_type>::value,
@@ -83,16 +91,32 @@ namespace asm_lsw {
 	public:
 		class h_type;
 		class f_type;
+		class child_table_type;
+		
+		// Parts of the matcher that may be serialized and loaded separately.
+		enum class component : uint8_t
+		{
+			gamma,
+			core_endpoints,
+			lcp_rmq,
+			h,
+			child_table
+		};
+		
+		static std::size_t const s_component_count{5};
 
 	protected:
 		struct transform_gamma_v;
 		
 	protected:
+		std::shared_ptr <pool_allocator_arena>	m_arena;	// Shared by the compact tries.
+		std::size_t			m_csa_cache_owner{0};		// Identifies the data for the thread's CSA cache.
 		cst_type const		*m_cst;
 		gamma_type			m_gamma;
 		core_endpoints_type	m_ce;
 		lcp_rmq_type		m_lcp_rmq;
 		h_type				m_h;
+		child_table_type	m_child_table;
 		
 	public:
 		
@@ -113,25 +137,27 @@ namespace asm_lsw {
 			*this = std::move(tmp_matcher);
 		}
 		
-		k1_matcher(cst_type const &cst, bool construct_ivars = true):
+		// Tabulate the children of the nodes of string depth at most child_table_depth (none if zero).
+		k1_matcher(cst_type const &cst, bool construct_ivars = true, size_type const child_table_depth = 0):
+			m_arena(new pool_allocator_arena()),
+			m_csa_cache_owner(csa_cache_type::next_owner_id()),
 			m_cst(&cst)
 		{
 			if (construct_ivars)
 			{
-				// Core path nodes
+				pool_allocator_arena::scope arena_scope(m_arena);
+				
+				// Core path nodes and endpoints
 				core_nodes_type cn;
-				construct_core_paths(cn);
+				core_endpoints_type ce;
+				construct_core_paths(cn, ce);
+				m_ce = std::move(ce);
 
 				// Gamma
 				gamma_type gamma;
 				construct_gamma_sets(cn, gamma);
 				m_gamma = std::move(gamma);
 			
-				// Core path endpoints
-				core_endpoints_type ce;
-				construct_core_path_endpoints(cn, ce);
-				m_ce = std::move(ce);
-			
 				// LCP RMQ
 				lcp_rmq_type lcp_rmq;
 				construct_lcp_rmq(lcp_rmq);
@@ -140,12 +166,23 @@ namespace asm_lsw {
 				// H
 				h_type h(*this);
 				m_h = std::move(h);
+				
+				// Child table
+				child_table_type child_table(cst, child_table_depth);
+				m_child_table = std::move(child_table);
 			}
 		}
 		
 		
 		cst_type const &cst() const { return *m_cst; }
+		pool_allocator_arena *arena() const { return m_arena.get(); }
 		core_endpoints_type const &core_path_endpoints() const { return m_ce; }
+		child_table_type const &child_table() const { return m_child_table; }
+		
+		// SA and ISA values accessed by the calling thread's queries, with hit and miss counts.
+		// The cache is shared by the queries made with the same matcher on the thread and
+		// cleared when a query is made with another matcher (or after loading this one).
+		static csa_cache_type &csa_cache() { thread_local csa_cache_type cache; return cache; }
 
 		
 		typename cst_type::size_type node_id(typename cst_type::node_type const node) const
@@ -172,12 +209,20 @@ namespace asm_lsw {
 		lcp_rmq_type::size_type lcp_length(lcp_rmq_type::size_type const l, lcp_rmq_type::size_type const r) const;
 		lcp_rmq_type::size_type lcp_length_e(lcp_rmq_type::size_type const l, lcp_rmq_type::size_type const r) const;
 		
-		void construct_core_paths(core_nodes_type &cn) const;
-		void construct_core_path_endpoints(core_nodes_type const &cn, core_endpoints_type &ce) const;
+		void construct_core_paths(core_nodes_type &cn, core_endpoints_type &ce) const;
 		void construct_uncompressed_gamma_sets(core_nodes_type const &cn, gamma_intermediate_type &gamma) const;
 		void construct_gamma_sets(core_nodes_type const &cn, gamma_type &gamma) const;
 		void construct_lcp_rmq(lcp_rmq_type &rmq) const;
 
+		typename csa_type::size_type cached_sa(typename csa_type::size_type const i) const { return csa_cache().sa(i); }
+		typename csa_type::size_type cached_isa(typename csa_type::size_type const i) const { return csa_cache().isa(i); }
+		
+		typename cst_type::node_type child(
+			typename cst_type::node_type const v,
+			typename cst_type::size_type const v_depth,
+			typename cst_type::char_type const c
+		) const;
+		
 		typename cst_type::size_type sa_idx_of_stored_isa_val(
 			typename cst_type::csa_type::isa_type::value_type const isa_val,
 			typename cst_type::size_type const pat1_len
@@ -278,6 +323,18 @@ namespace asm_lsw {
 		
 		size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, std::string name = "") const;
 		void load(std::istream &in);
+		
+		static char const *component_name(component const c);
+		size_type serialize_component(component const c, std::ostream &out, sdsl::structure_tree_node *v = nullptr) const;
+		
+		// Load the components concurrently. open_fn(c) is called on the loading thread and should
+		// return a std::unique_ptr to a stream positioned at the beginning of component c.
+		template <typename t_open_fn>
+		void load_components(t_open_fn &&open_fn, std::size_t const thread_count = 0);
+		
+	protected:
+		void reset_arena();
+		void load_component(component const c, std::istream &in);
 	};
 	
 	
@@ -301,6 +358,24 @@ namespace asm_lsw {
 	}
 	
 	
+	// Find the child of v by c. Use the child table if v is near the root, i.e. if its string
+	// depth v_depth does not exceed the tabulated depth. Return the root if there is no such child.
+	template <typename t_cst>
+	auto k1_matcher <t_cst>::child(
+		typename cst_type::node_type const v,
+		typename cst_type::size_type const v_depth,
+		typename cst_type::char_type const c
+	) const -> typename cst_type::node_type
+	{
+		typename cst_type::node_type w{};
+		if (m_child_table.child(*m_cst, v, v_depth, c, w))
+			return w;
+		
+		typename cst_type::size_type char_pos(0);
+		return m_cst->child(v, c, char_pos);
+	}
+	
+	
 	// Check if the given node is a side node as per section 2.5.
 	// FIXME: calculate time complexity.
 	template <typename t_cst>
@@ -346,16 +421,29 @@ namespace asm_lsw {
 	
 	
 	// Construct a bit vector core_nodes for listing core nodes. (Not included in the paper but needed for section 3.1.)
+	// Also construct the core path endpoints from Lemma 15 in the same pass. Each core path
+	// begins at the root or at a non-leaf side node and ends at the leaf reached by following
+	// the heaviest children, so the endpoints may be recorded when the side node's parent is visited.
 	// Space complexity: O(n) bits since the number of nodes in a suffix tree with |T| = n is 2n = O(n).
 	// FIXME: calculate time complexity.
 	template <typename t_cst>
-	void k1_matcher <t_cst>::construct_core_paths(core_nodes_type &cn) const
+	void k1_matcher <t_cst>::construct_core_paths(core_nodes_type &cn, core_endpoints_type &ce) const
 	{
+		// Leaf counts and the identifiers of the leaves at the ends of the heaviest paths.
 		std::map <
 			typename cst_type::node_type,
-			typename cst_type::size_type
+			std::pair <typename cst_type::size_type, typename cst_type::size_type>
 		> node_counts;
-		sdsl::bit_vector core_nodes(m_cst->nodes(), 0); // Nodes with incoming core edges.
+		auto const node_count(m_cst->nodes());
+		sdsl::bit_vector core_nodes(node_count, 0);	// Nodes with incoming core edges.
+		sdsl::bit_vector mask(node_count, 0);		// Core path endpoints.
+		size_t path_count(0);
+		
+		auto const add_path([this, &mask, &path_count](typename cst_type::node_type const node, typename cst_type::size_type const leaf_id){
+			mask[node_id(node)] = 1;
+			mask[leaf_id] = 1;
+			++path_count;
+		});
 		
 		// Count node depths from the bottom and choose the greatest.
 		for (auto it(m_cst->begin_bottom_up()), end(m_cst->end_bottom_up()); it != end; ++it)
@@ -363,7 +451,7 @@ namespace asm_lsw {
 			typename cst_type::node_type node(*it);
 			if (m_cst->is_leaf(node))
 			{
-				auto res(node_counts.emplace(std::make_pair(node, 1)));
+				auto res(node_counts.emplace(node, std::make_pair(1, node_id(node))));
 				assert(res.second); // Insertion should have happened.
 			}
 			else
@@ -371,6 +459,7 @@ namespace asm_lsw {
 				// Not a leaf, iterate the children and choose.
 				typename cst_type::size_type sum_nc(0);
 				typename cst_type::size_type max_nc(0);
+				typename cst_type::size_type argmax_leaf_id(0);
 				typename cst_type::node_type argmax_nc(m_cst->root());
 				
 				auto children(m_cst->children(node));
@@ -379,13 +468,22 @@ namespace asm_lsw {
 					auto c_it(node_counts.find(child));
 					assert(node_counts.end() != c_it);
 					
-					auto const nc(c_it->second);
+					auto const nc(c_it->second.first);
 					sum_nc += nc;
 					if (max_nc < nc)
 					{
-						max_nc = c_it->second;
+						max_nc = nc;
 						argmax_nc = c_it->first;
+						argmax_leaf_id = c_it->second.second;
 					}
+				}
+				
+				// The other children are side nodes that begin core paths unless they are leaves.
+				for (auto const child : children)
+				{
+					auto c_it(node_counts.find(child));
+					if (argmax_nc != child && !m_cst->is_leaf(child))
+						add_path(child, c_it->second.second);
 					
 					// c_it->first is not needed anymore.
 					node_counts.erase(c_it);
@@ -395,88 +493,37 @@ namespace asm_lsw {
 				typename cst_type::size_type nid(node_id(argmax_nc));
 				core_nodes[nid] = 1;
 				
-				//std::cerr << "node (" << nid << "): " << node << " heaviest child (" << max_nc << "): " << argmax_nc << std::endl;
-
-				auto res(node_counts.emplace(std::make_pair(node, 1 + sum_nc)));
+				auto res(node_counts.emplace(node, std::make_pair(1 + sum_nc, argmax_leaf_id)));
 				assert(res.second); // Insertion should have happened.
 			}
 		}
 		
-		cn = std::move(core_nodes);
-	}
-	
-	
-	// Core path endpoints from Lemma 15.
-	// FIXME: calculate time complexity.
-	template <typename t_cst>
-	void k1_matcher <t_cst>::construct_core_path_endpoints(core_nodes_type const &cn, core_endpoints_type &ce) const
-	{
-		auto const leaf_count(m_cst->size());
-		auto const node_count(m_cst->nodes());
-		size_t path_count(0);
-		sdsl::bit_vector path_endpoints;
-		sdsl::bit_vector mask;
-
+		// The root begins the last core path.
 		{
-			sdsl::bit_vector opening(node_count, 0);
-			sdsl::bit_vector closing(node_count, 0);
-			
-			// Find the '(' endpoint for each of the ')' endpoints in the leaves and count the paths.
-			// The '(' endpoint will not have a bit set in cn.
-			for (typename cst_type::size_type i(0); i < leaf_count; ++i)
+			auto const root(m_cst->root());
+			if (!m_cst->is_leaf(root))
 			{
-				auto const leaf(m_cst->select_leaf(1 + i));
-				auto const leaf_id(node_id(leaf));
-				if (cn[leaf_id])
-				{
-					++path_count;
-					closing[leaf_id] = 1;
-
-					auto node(leaf);
-					do
-					{
-						assert(m_cst->root() != node);
-						node = m_cst->parent(node);
-					}
-					while (cn[node_id(node)]);
-					
-					auto const nid(node_id(node));
-					opening[nid] = 1;
-					
-					//std::cerr << "Ep1: " << node_inv_id(nid) << " ep2: " << node_inv_id(leaf_id) << std::endl;
-				}
-			}
-			
-			// Iterate the opening and closing vectors. If either has a bit set,
-			// advance in the endpoint vector.
-			{
-				sdsl::bit_vector tmp(2 * path_count, 0);
-				path_endpoints = std::move(tmp);
+				auto const r_it(node_counts.find(root));
+				assert(node_counts.end() != r_it);
+				add_path(root, r_it->second.second);
 			}
-			
-			// Dense representation of the balanced parentheses.
-			decltype(path_count) j{0};
-			for (util::remove_c_t<decltype(node_count)> i{0}; i < node_count; ++i)
+		}
+		
+		// Dense representation of the balanced parentheses. The closing endpoints are the leaves.
+		sdsl::bit_vector path_endpoints(2 * path_count, 0);
+		decltype(path_count) j{0};
+		for (util::remove_c_t <decltype(node_count)> i{0}; i < node_count; ++i)
+		{
+			if (mask[i])
 			{
-				if (opening[i])
-				{
+				if (!m_cst->is_leaf(node_inv_id(i)))
 					path_endpoints[j] = 1;
-					++j;
-				}
-				else if (closing[i])
-				{
-					++j;
-				}
+				++j;
 			}
-			assert(2 * path_count == j);
-
-			// Mask of the sparse representation.
-			// Somehow |= is not ok.
-			for (util::remove_c_t<decltype(node_count)> i{0}; i < node_count; ++i)
-				opening[i] = opening[i] | closing[i];
-
-			mask = std::move(opening);
 		}
+		assert(2 * path_count == j);
+		
+		cn = std::move(core_nodes);
 		
 		{
 			core_endpoints_type tmp(std::move(path_endpoints), std::move(mask));
@@ -548,8 +595,9 @@ namespace asm_lsw {
 		gamma_intermediate_type gamma_i;
 		construct_uncompressed_gamma_sets(cn, gamma_i);
 		
-		typename gamma_type::template builder_type <gamma_intermediate_type, transform_gamma_v> builder(gamma_i);
-		gamma_type gamma_tmp(builder);
+		// Construct the compact tries in parallel since each of them has PHFs of its own.
+		typename gamma_type::template parallel_builder_type <gamma_intermediate_type, transform_gamma_v> builder(gamma_i);
+		gamma_type gamma_tmp(builder.builder());
 		gamma = std::move(gamma_tmp);
 	}
 	
@@ -570,10 +618,9 @@ namespace asm_lsw {
 		typename cst_type::size_type const pat1_len
 	) const -> typename cst_type::size_type
 	{
-		auto const &csa(m_cst->csa);
-		auto const isa_idx(csa[isa_val]);
+		auto const isa_idx(cached_sa(isa_val));
 		auto const sa_val(isa_idx - pat1_len - 1);
-		auto const sa_idx(csa.isa[sa_val]);
+		auto const sa_idx(cached_isa(sa_val));
 		return sa_idx;
 	}
 
@@ -591,44 +638,35 @@ namespace asm_lsw {
 	) const
 	{
 		auto const &csa(m_cst->csa);
-		
-		if (rb < lb)
-			return false;
-		
-		auto const mid(lb + (rb - lb) / 2);
 		auto const &isa(csa.isa);
-		auto const isa_idx(csa[mid] + pat1_len + 1);
-		
-		// Make sure that the pattern isn't too long.
-		if (isa.size() <= isa_idx)
-		{
-			// By Lemma 12 ISA[SA[i] + |P₁| + 1] is increasing for i ∈ [v_le, v_ri].
-			assert(isa.size() <= csa[lb] + pat1_len + 1);
-			return false;
-		}
+		auto &cache(csa_cache());
 		
-		auto const val(isa[isa_idx]);
+		// Locate SA[j] for the next two levels of the search and prefetch the ISA samples, so that
+		// the ISA accesses of the two probes overlap. One of the quartiles is not probed, which
+		// costs one SA access per two levels.
+		auto const prefetch_fn([&cache, &isa, pat1_len](typename csa_type::size_type const j){
+			auto const isa_idx(cache.sa(j) + pat1_len + 1);
+			if (isa_idx < isa.size())
+				cache.prefetch_isa(isa_idx);
+		});
 		
-		// Tail recursion.
-		if (st <= val && val <= ed)
-		{
-			i = mid;
-			return true;
-		}
-		else if (val < st)
-		{
-			return find_pattern_occurrence(pat1_len, st, ed, 1 + mid, rb, i);
-		}
-		else
-		{
-			assert(ed < val);
+		// By Lemma 12 ISA[SA[i] + |P₁| + 1] is increasing for i ∈ [v_le, v_ri].
+		return util::search_monotone_batched(lb, rb, i, prefetch_fn, [this, &isa, pat1_len, st, ed](typename csa_type::size_type const mid){
+			auto const isa_idx(cached_sa(mid) + pat1_len + 1);
 			
-			// Prevent overflow for mid - 1.
-			if (lb == mid)
-				return false;
+			// Make sure that the pattern isn't too long.
+			if (isa.size() <= isa_idx)
+				return util::search_direction::stop;
 			
-			return find_pattern_occurrence(pat1_len, st, ed, lb, mid - 1, i);
-		}
+			auto const val(cached_isa(isa_idx));
+			if (val < st)
+				return util::search_direction::right;
+			
+			if (ed < val)
+				return util::search_direction::left;
+			
+			return util::search_direction::found;
+		});
 	}
 	
 	
@@ -643,31 +681,20 @@ namespace asm_lsw {
 		typename csa_type::size_type &i
 	) const
 	{
-		t_cmp <typename csa_type::size_type> cmp;
-		
 		assert(l <= r);
-
-		auto const mid(l + (r - l) / 2);
-		auto const res(lcp_length_e(std::min(mid, k), std::max(mid, k)));
-
-		// Tail recursion.
-		if (cmp(res, r_len))
-		{
-			if (mid == r)
-				return false;
-			return find_node_ilr_bin <t_cmp>(k, r_len, 1 + mid, r, i);
-		}
-		else if (cmp(r_len, res))
-		{
-			if (mid == l)
-				return false;
-			return find_node_ilr_bin <t_cmp>(k, r_len, l, mid - 1, i);
-		}
-		else
-		{
-			i = mid;
-			return true;
-		}
+		
+		return util::search_monotone(l, r, i, [this, k, r_len](typename csa_type::size_type const mid){
+			t_cmp <typename csa_type::size_type> cmp;
+			auto const res(lcp_length_e(std::min(mid, k), std::max(mid, k)));
+			
+			if (cmp(res, r_len))
+				return util::search_direction::right;
+			
+			if (cmp(r_len, res))
+				return util::search_direction::left;
+			
+			return util::search_direction::found;
+		});
 	}
 
 
@@ -685,7 +712,7 @@ namespace asm_lsw {
 	) const
 	{
 		typename csa_type::size_type l(0), r(0);
-		typename h_type::h_u_type::const_subtree_iterator it;
+		typename h_type::h_u_type::key_type found_key(0);
 		auto const h_diff(m_h.diff());
 		auto const lcp_rmq_size(m_lcp_rmq.size());
 		auto const lcp_rmq_max(lcp_rmq_size ? lcp_rmq_size - 1 : 0);
@@ -694,9 +721,8 @@ namespace asm_lsw {
 		// since k has the longest lcp with itself.
 
 		// Try i^l.
-		if (hx.l.get() && hx.l->find_successor(r_len, it, true))
+		if (hx.l.get() && hx.l->find_successor(r_len, found_key, r, true))
 		{
-			r = hx.l->iterator_value(it);
 			l = ((h_diff <= r) ? (r - h_diff) : 0);
 			assert(r < k);
 			assert(l <= r);
@@ -705,9 +731,8 @@ namespace asm_lsw {
 		}
 
 		// Try i^r.
-		if (hx.r.get() && hx.r->find_predecessor(r_len, it, true))
+		if (hx.r.get() && hx.r->find_predecessor(r_len, found_key, l, true))
 		{
-			l = hx.r->iterator_value(it);
 			r = ((l + h_diff <= lcp_rmq_max) ? (l + h_diff) : lcp_rmq_max);
 			assert(k < l);
 			assert(l <= r);
@@ -752,11 +777,11 @@ namespace asm_lsw {
 			assert(v_le < left);
 			auto const i(left - 1);
 			
-			auto const isa_idx(csa[i] + pat1_len + 1);
+			auto const isa_idx(cached_sa(i) + pat1_len + 1);
 			if (! (isa_idx < isa.size()))
 				break;
 			
-			if (! (st <= isa[isa_idx]))
+			if (! (st <= cached_isa(isa_idx)))
 				break;
 			
 			left = i;
@@ -770,11 +795,11 @@ namespace asm_lsw {
 			assert(right < v_ri);
 			auto const i(right + 1);
 			
-			auto const isa_idx(csa[i] + pat1_len + 1);
+			auto const isa_idx(cached_sa(i) + pat1_len + 1);
 			if (! (isa_idx < isa.size()))
 				break;
 			
-			if (! (isa[isa_idx] <= ed))
+			if (! (cached_isa(isa_idx) <= ed))
 				break;
 			
 			right = i;
@@ -807,14 +832,13 @@ namespace asm_lsw {
 		}
 		else
 		{
-			// Find a j s.t. st ≤ j ≤ ed by allowing equality and checking the upper bound.
-			typename gamma_v_type::const_subtree_iterator it;
+			// Find a j s.t. st ≤ j ≤ ed. The range query avoids constructing an iterator.
+			typename gamma_v_type::key_type isa_val(0);
 			assert(gamma_v->size());
-			if (gamma_v->find_successor(st, it, true) && *it <= ed)
+			if (gamma_v->range_exists(st, ed, isa_val))
 			{
 				// Case 2.
 				// Get i from j = ISA[SA[i] + |P₁| + 1].
-				auto const isa_val(*it);
 				i = sa_idx_of_stored_isa_val(isa_val, pat1_len);
 				return true;
 			}
@@ -825,20 +849,14 @@ namespace asm_lsw {
 				// should be between st and ed in which case the method in case 2
 				// would be applicable as the number of leaves is small enough.
 				// XXX verify the statement above.
-				typename gamma_v_type::const_subtree_iterator a_val_it, b_val_it;
+				typename gamma_v_type::key_type a_val(0), b_val(0);
 				typename csa_type::size_type a(v_le), b(v_ri);
 				
-				if (gamma_v->find_predecessor(st, a_val_it))
-				{
-					auto const a_val(*a_val_it);
+				if (gamma_v->find_predecessor(st, a_val))
 					a = sa_idx_of_stored_isa_val(a_val, pat1_len);
-				}
 				
-				if (gamma_v->find_successor(ed, b_val_it))
-				{
-					auto const b_val(*b_val_it);
+				if (gamma_v->find_successor(ed, b_val))
 					b = sa_idx_of_stored_isa_val(b_val, pat1_len);
-				}
 				
 				if (find_pattern_occurrence(pat1_len, st, ed, a, b, i))
 					return true;
@@ -865,8 +883,8 @@ namespace asm_lsw {
 		typename csa_type::size_type &right
 	) const
 	{
-		typename cst_type::size_type pos(0);
-		auto const v(m_cst->child(u, c, pos));
+		auto const pat1_len(m_cst->depth(u));
+		auto const v(child(u, pat1_len, c));
 	
 		// Check if found.
 		if (m_cst->root() == v)
@@ -875,7 +893,6 @@ namespace asm_lsw {
 		typename csa_type::size_type i(0);
 		
 		auto const v_id(node_id(v));
-		auto const pat1_len(m_cst->depth(u));
 		auto const v_le(m_cst->lb(v));
 		auto const v_ri(m_cst->rb(v));
 
@@ -927,13 +944,13 @@ namespace asm_lsw {
 				
 				// Get the suffix array index.
 				auto const k(m_cst->id(x));
-				auto const isa_idx(csa[k] + pat1_len + 1);
+				auto const isa_idx(cached_sa(k) + pat1_len + 1);
 				
 				// Check if the pattern may still be found in the suffix tree.
 				if (! (isa_idx < isa.size()))
 					return false;
 				
-				auto const isa_val(isa[isa_idx]);
+				auto const isa_val(cached_isa(isa_idx));
 				auto const q(lcp_length_e(std::min(isa_val, st), std::max(isa_val, st)));
 				auto const pat2_len(pattern.size() - pat_idx);
 				if (q >= pat2_len)
@@ -1084,8 +1101,7 @@ namespace asm_lsw {
 				goto end;
 			
 			// Find the next edge, stop if not found.
-			typename cst_type::size_type char_pos(0);
-			v = m_cst->child(v, pattern[pidx], char_pos);
+			v = child(v, len, pattern[pidx]);
 			
 			if (m_cst->root() == v)
 				return false;
@@ -1110,6 +1126,11 @@ namespace asm_lsw {
 		csa_ranges &ranges
 	) const
 	{
+		// The characters tried in substitutions and insertions.
+		typedef typename pattern_alphabet <t_pattern>::type alphabet_type;
+		
+		csa_cache().bind(m_cst->csa, m_csa_cache_owner);
+		
 		bool found(false);
 		f_type const f(*this, pattern);
 		typename cst_type::node_type u(m_cst->root());
@@ -1131,41 +1152,40 @@ namespace asm_lsw {
 			
 			// 2. Substitution.
 			// Test with all the characteres in Sigma.
-			for (typename cst_type::sigma_type c(0); c < m_cst->csa.sigma; ++c)
-			{
-				auto const cc(m_cst->csa.comp2char[c]);
+			if (alphabet_type::for_each_char(*m_cst, [&](typename cst_type::char_type const cc){
 				if (pattern[i] != cc)
 				{
 					found |= find_1_approximate_at_i <t_find_all_matches>(pattern, f, u, core_path_beginning, 1 + i, cc, ranges);
 					if (!t_find_all_matches && found)
 						return true;
 				}
-			}
+				return false;
+			}))
+				return true;
 			
 			// 3. Insertion.
 			// Allow insertion of the same character to the end of the string.
-			for (typename cst_type::sigma_type c(0); c < m_cst->csa.sigma; ++c)
-			{
-				auto const cc(m_cst->csa.comp2char[c]);
+			if (alphabet_type::for_each_char(*m_cst, [&](typename cst_type::char_type const cc){
 				if (1 + i == pattern.size() || pattern[i] != cc)
 				{
 					found |= find_1_approximate_at_i <t_find_all_matches>(pattern, f, u, core_path_beginning, i, cc, ranges);
 					if (!t_find_all_matches && found)
 						return true;
 				}
-			}
+				return false;
+			}))
+				return true;
 
 			// 4. Exact match.
 			auto const cc(pattern[i]);
-			typename cst_type::size_type char_pos{0};
-			auto const v(m_cst->child(u, cc, char_pos));
+			assert(i == m_cst->depth(u));
+			auto const v(child(u, i, cc));
 			
 			// Character at i doesn't match; there won't be more
 			// matches since k = 1.
 			if (m_cst->root() == v)
 				return found;
 			
-			assert(i == m_cst->depth(u));
 			auto k(i);
 			auto const len(m_cst->depth(v));
 			while (true)
@@ -1245,10 +1265,8 @@ namespace asm_lsw {
 		auto *child(sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this)));
 		size_type written_bytes(0);
 
-		written_bytes += m_gamma.serialize(out, child, name);
-		written_bytes += m_ce.serialize(out, child, name);
-		written_bytes += m_lcp_rmq.serialize(out, child, name);
-		written_bytes += m_h.serialize(out, child, name);
+		for (std::size_t i(0); i < s_component_count; ++i)
+			written_bytes += serialize_component(static_cast <component>(i), out, child);
 		
 		sdsl::structure_tree::add_size(child, written_bytes);
 		return written_bytes;
@@ -1258,10 +1276,113 @@ namespace asm_lsw {
 	template <typename t_cst>
 	void k1_matcher <t_cst>::load(std::istream &in)
 	{
-		m_gamma.load(in);
-		m_ce.load(in);
-		m_lcp_rmq.load(in);
-		m_h.load(in);
+		reset_arena();
+		pool_allocator_arena::scope arena_scope(m_arena);
+		
+		for (std::size_t i(0); i < s_component_count; ++i)
+			load_component(static_cast <component>(i), in);
+	}
+	
+	
+	template <typename t_cst>
+	char const *k1_matcher <t_cst>::component_name(component const c)
+	{
+		switch (c)
+		{
+			case component::gamma:
+				return "gamma";
+			case component::core_endpoints:
+				return "core_endpoints";
+			case component::lcp_rmq:
+				return "lcp_rmq";
+			case component::h:
+				return "h";
+			case component::child_table:
+				return "child_table";
+			default:
+				assert(0);
+				return "";
+		}
+	}
+	
+	
+	template <typename t_cst>
+	auto k1_matcher <t_cst>::serialize_component(
+		component const c,
+		std::ostream &out,
+		sdsl::structure_tree_node *v
+	) const -> size_type
+	{
+		auto const name(component_name(c));
+		switch (c)
+		{
+			case component::gamma:
+				return m_gamma.serialize(out, v, name);
+			case component::core_endpoints:
+				return m_ce.serialize(out, v, name);
+			case component::lcp_rmq:
+				return m_lcp_rmq.serialize(out, v, name);
+			case component::h:
+				return m_h.serialize(out, v, name);
+			case component::child_table:
+				return m_child_table.serialize(out, v, name);
+			default:
+				assert(0);
+				return 0;
+		}
+	}
+	
+	
+	template <typename t_cst>
+	template <typename t_open_fn>
+	void k1_matcher <t_cst>::load_components(t_open_fn &&open_fn, std::size_t const thread_count)
+	{
+		// The components are independent and the arena is shared. The current arena
+		// is set per thread, so make it current in each of the loading threads.
+		reset_arena();
+		
+		util::parallel_for(s_component_count, thread_count, [&](std::size_t const i){
+			pool_allocator_arena::scope arena_scope(m_arena);
+			auto const c(static_cast <component>(i));
+			auto stream(open_fn(c));
+			load_component(c, *stream);
+		});
+	}
+	
+	
+	template <typename t_cst>
+	void k1_matcher <t_cst>::reset_arena()
+	{
+		// Allocate the loaded tries from a new arena.
+		m_arena.reset(new pool_allocator_arena());
+		m_csa_cache_owner = csa_cache_type::next_owner_id();
+	}
+	
+	
+	template <typename t_cst>
+	void k1_matcher <t_cst>::load_component(component const c, std::istream &in)
+	{
+		switch (c)
+		{
+			case component::gamma:
+				m_gamma.load(in);
+				break;
+			case component::core_endpoints:
+				m_ce.load(in);
+				break;
+			case component::lcp_rmq:
+				m_lcp_rmq.load(in);
+				break;
+			case component::h:
+				m_h.load(in);
+				break;
+			case component::child_table:
+				m_child_table.load(in);
+				break;
+			default:
+				assert(0);
+				break;
+		}
 	}
 }
 
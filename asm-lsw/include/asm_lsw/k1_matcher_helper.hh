@@ -48,8 +48,8 @@ namespace asm_lsw {
 				auto *child(sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this)));
 				size_type written_bytes(0);
 				
-				written_bytes += l.serialize(out, child, name);
-				written_bytes += r.serialize(out, child, name);
+				written_bytes += l.serialize(out, child, "l");
+				written_bytes += r.serialize(out, child, "r");
 				
 				sdsl::structure_tree::add_size(child, written_bytes);
 				return written_bytes;
@@ -193,10 +193,14 @@ namespace asm_lsw {
 			auto const &ce_bps(ce.bps());
 			auto const count(ce_bps.rank(ce_bps.size() - 1));
 			
-			h_map_intermediate maps_i;
-			
-			for (util::remove_c_t<decltype(count)> i{0}; i < count; ++i)
-			{
+			// The core paths are independent, so handle them in parallel and
+			// collect the results by core path index. The tries are allocated
+			// from the matcher's arena, which is current per thread.
+			std::vector <typename cst_type::size_type> u_ids(count);
+			std::vector <h_pair> h_pairs(count);
+			util::parallel_for(count, 0, [&](std::size_t const i){
+				pool_allocator_arena::scope arena_scope(matcher.m_arena);
+				
 				// Find the index of each opening parenthesis and its counterpart,
 				// then convert to sparse index.
 				auto const ce_bps_begin(ce_bps.select(1 + i));
@@ -208,10 +212,13 @@ namespace asm_lsw {
 				
 				// u is now a core leaf node.
 				assert(cst.is_leaf(u));
-				h_pair h_u;
-				construct_hl_hr(matcher, v, u, log2n, h_u);
-				maps_i[u_id] = std::move(h_u);
-			}
+				construct_hl_hr(matcher, v, u, log2n, h_pairs[i]);
+				u_ids[i] = u_id;
+			});
+			
+			h_map_intermediate maps_i;
+			for (util::remove_c_t<decltype(count)> i{0}; i < count; ++i)
+				maps_i[u_ids[i]] = std::move(h_pairs[i]);
 			
 			typename h_map::template builder_type <h_map_intermediate> builder(maps_i);
 			h_map maps_tmp(builder);
@@ -224,7 +231,7 @@ namespace asm_lsw {
 			auto *child(sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this)));
 			size_type written_bytes(0);
 			
-			written_bytes += m_maps.serialize(out, child, name);
+			written_bytes += m_maps.serialize(out, child, "maps");
 			written_bytes += sdsl::write_member(m_diff, out, child, "diff");
 		
 			sdsl::structure_tree::add_size(child, written_bytes);
@@ -248,6 +255,9 @@ namespace asm_lsw {
 		typedef f_vector_type::size_type size_type;
 		static f_vector_type::value_type const not_found{std::numeric_limits<f_vector_type::value_type>::max()};
 		
+		// Selects the construction that searches the CST forward and follows the suffix links.
+		struct forward_search_tag {};
+		
 	protected:
 		f_vector_type m_st;
 		f_vector_type m_ed;
@@ -267,15 +277,55 @@ namespace asm_lsw {
 		}
 
 
+		size_type size() const { return m_st.size(); }
+
+
 		f_type()
 		{
 		}
+		
+		
+		// Construct the F arrays as defined in definitions 1 and 2 and lemma 10.
+		// F_st[i] and F_ed[i] are the bounds of the SA range of pattern[i..m], so they may be
+		// computed for all i with one backward search from the end of the pattern.
+		// Time complexity O(|pattern| * t_LF).
+		template <typename t_pattern>
+		f_type(k1_matcher const &matcher, t_pattern const &pattern)
+		{
+			auto const &csa(matcher.cst().csa);
+			auto const m(pattern.size());
+			
+			f_vector_type st(m, not_found);
+			f_vector_type ed(m, not_found);
+			
+			typename csa_type::size_type lb(0);
+			typename csa_type::size_type rb(csa.size() - 1);
+			auto i(m);
+			while (i)
+			{
+				--i;
+				
+				// If pattern[i..m] does not occur in the text, neither do the longer suffixes
+				// of the pattern, so the rest of the values remain not_found.
+				typename csa_type::size_type res_lb(0), res_rb(0);
+				if (0 == sdsl::backward_search(csa, lb, rb, pattern[i], res_lb, res_rb))
+					break;
+				
+				lb = res_lb;
+				rb = res_rb;
+				st[i] = lb;
+				ed[i] = rb;
+			}
+			
+			m_st = std::move(st);
+			m_ed = std::move(ed);
+		}
 
 
-		// Construct the F arrays as defined in definitions 1 and 2 and lemma 10.
+		// Construct the F arrays by searching the CST forward and following the suffix links.
 		// FIXME: calculate time complexity.
 		template <typename t_pattern>
-		f_type(k1_matcher const &matcher, t_pattern const &pattern)
+		f_type(k1_matcher const &matcher, t_pattern const &pattern, forward_search_tag)
 		{
 			auto const &cst(matcher.cst());
 			auto const m(pattern.size());
@@ -337,6 +387,132 @@ namespace asm_lsw {
 	};
 
 	
+	// Children of the internal nodes the string depth of which is at most max_depth,
+	// indexed by node and compact character. Every search starts from the root, so the
+	// upper levels of the suffix tree are visited for every pattern.
+	template <typename t_cst>
+	class k1_matcher <t_cst>::child_table_type
+	{
+	public:
+		typedef std::size_t						size_type;
+		typedef typename cst_type::node_type	node_type;
+	
+	protected:
+		typedef unordered_map <node_type, size_type>	row_map;
+		typedef std::map <node_type, size_type>			row_map_intermediate;
+	
+	protected:
+		row_map			m_rows;			// Row index of each tabulated node.
+		int_vector_type	m_children;		// sigma children per row, root if missing.
+		size_type		m_sigma{0};
+		size_type		m_max_depth{0};
+	
+	public:
+		child_table_type()
+		{
+		}
+		
+		
+		// Time complexity O(k * sigma * t_SA), where k is the number of tabulated nodes.
+		child_table_type(cst_type const &cst, size_type const max_depth):
+			m_sigma(cst.csa.sigma),
+			m_max_depth(max_depth)
+		{
+			if (0 == max_depth)
+				return;
+			
+			row_map_intermediate rows_i;
+			std::vector <node_type> children;
+			std::vector <node_type> stack{cst.root()};
+			while (!stack.empty())
+			{
+				auto const v(stack.back());
+				stack.pop_back();
+				
+				auto const row(rows_i.size());
+				rows_i.emplace(v, row);
+				children.resize(children.size() + m_sigma, cst.root());
+				
+				auto const depth(cst.depth(v));
+				for (auto const w : cst.children(v))
+				{
+					auto const comp(cst.csa.char2comp[cst.edge(w, 1 + depth)]);
+					children[row * m_sigma + comp] = w;
+					
+					if (!cst.is_leaf(w) && cst.depth(w) <= max_depth)
+						stack.push_back(w);
+				}
+			}
+			
+			int_vector_type children_tmp(children.size(), 0);
+			std::copy(children.cbegin(), children.cend(), children_tmp.begin());
+			sdsl::util::bit_compress(children_tmp);
+			m_children = std::move(children_tmp);
+			
+			typename row_map::template builder_type <row_map_intermediate> builder(rows_i);
+			row_map rows_tmp(builder);
+			m_rows = std::move(rows_tmp);
+		}
+		
+		
+		size_type max_depth() const { return m_max_depth; }
+		size_type size() const { return m_rows.size(); }
+		
+		
+		// If v has been tabulated, set w to its child by c (or to the root if there is
+		// no such child) and return true. v_depth is the string depth of v; deeper nodes
+		// are not tabulated, so they are rejected without a lookup.
+		bool child(
+			cst_type const &cst,
+			node_type const v,
+			typename cst_type::size_type const v_depth,
+			typename cst_type::char_type const c,
+			node_type &w
+		) const
+		{
+			if (0 == m_max_depth || m_max_depth < v_depth)
+				return false;
+			
+			auto const it(m_rows.find(v));
+			if (m_rows.cend() == it)
+				return false;
+			
+			// Same as in cst_sada::child.
+			auto const comp(cst.csa.char2comp[c]);
+			if (0 == comp && 0 != c)
+				w = cst.root();
+			else
+				w = m_children[it->second * m_sigma + comp];
+			
+			return true;
+		}
+		
+		
+		size_type serialize(std::ostream &out, sdsl::structure_tree_node *v, std::string name) const
+		{
+			auto *child(sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this)));
+			size_type written_bytes(0);
+			
+			written_bytes += m_rows.serialize(out, child, "rows");
+			written_bytes += m_children.serialize(out, child, "children");
+			written_bytes += sdsl::write_member(m_sigma, out, child, "sigma");
+			written_bytes += sdsl::write_member(m_max_depth, out, child, "max_depth");
+			
+			sdsl::structure_tree::add_size(child, written_bytes);
+			return written_bytes;
+		}
+		
+		
+		void load(std::istream &in)
+		{
+			m_rows.load(in);
+			m_children.load(in);
+			sdsl::read_member(m_sigma, in);
+			sdsl::read_member(m_max_depth, in);
+		}
+	};
+	
+	
 	template <typename t_cst>
 	struct k1_matcher <t_cst>::transform_gamma_v
 	{
@@ -124,9 +124,9 @@ namespace asm_lsw {
 	public:
 		kn_matcher() {}
 		
-		kn_matcher(cst_type const &cst, bool construct_matcher_ivars = true):
+		kn_matcher(cst_type const &cst, bool construct_matcher_ivars = true, size_type const child_table_depth = 0):
 			m_cst(&cst),
-			m_matcher(cst, construct_matcher_ivars)
+			m_matcher(cst, construct_matcher_ivars, child_table_depth)
 		{
 		}
 		
@@ -137,6 +137,15 @@ namespace asm_lsw {
 		
 		size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, std::string name = "") const;
 		void load(std::istream &in);
+		
+		// Access to the separately serializable parts of the k = 1 matcher.
+		k1_matcher_type const &matcher() const { return m_matcher; }
+		
+		template <typename t_open_fn>
+		void load_components(t_open_fn &&open_fn, std::size_t const thread_count = 0)
+		{
+			m_matcher.load_components(std::forward <t_open_fn>(open_fn), thread_count);
+		}
 	};
 	
 	
@@ -174,7 +183,7 @@ namespace asm_lsw {
 		auto *child(sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this)));
 		size_type written_bytes(0);
 
-		written_bytes += m_matcher.serialize(out, child, name);
+		written_bytes += m_matcher.serialize(out, child, "k1_matcher");
 		
 		sdsl::structure_tree::add_size(child, written_bytes);
 		return written_bytes;
@@ -21,13 +21,17 @@
 #include <asm_lsw/map_adaptor_helper.hh>
 #include <asm_lsw/map_adaptor_phf_helper.hh>
 #include <asm_lsw/phf_wrapper.hh>
+#include <asm_lsw/pool_allocator.hh>
 #include <asm_lsw/util.hh>
+#include <array>
 #include <boost/core/enable_if.hpp>
 #include <boost/iterator/iterator_facade.hpp>
+#include <memory>
 #include <sdsl/int_vector.hpp>
 #include <sdsl/rank_support.hpp>
 #include <sdsl/select_support.hpp>
 #include <type_traits>
+#include <vector>
 
 
 namespace asm_lsw {
@@ -37,18 +41,32 @@ namespace asm_lsw {
 	
 	template <typename t_spec, typename t_map, typename t_access_value_fn>
 	class map_adaptor_phf_builder;
+	
+	template <typename t_spec, typename t_map, typename t_access_value_fn>
+	class map_adaptor_phf_parallel_builder;
 
 
+	// The PHF construction parameters are passed to PHF::init. t_phf_lambda is the average
+	// number of keys per displacement bucket and t_phf_alpha the loading factor as a percentage.
+	// If t_compress_slots is true, only one slot per element is allocated and the hash value
+	// is mapped to a slot with rank on the used indices, which makes the hash minimal.
 	template <
 		template <typename ...> class t_vector,
 		template <typename> class t_allocator,
 		typename t_key,
 		typename t_val,
 		bool t_enable_serialize = false,
-		typename t_access_key_fn = map_adaptor_access_key <t_key>
+		typename t_access_key_fn = map_adaptor_access_key <t_key>,
+		std::size_t t_phf_lambda = 4,
+		std::size_t t_phf_alpha = 80,
+		uint32_t t_phf_seed = 0,
+		bool t_compress_slots = false
 	>
 	struct map_adaptor_phf_spec
 	{
+		static_assert(0 < t_phf_lambda, "PHF lambda needs to be positive.");
+		static_assert(0 < t_phf_alpha && t_phf_alpha <= 100, "PHF loading factor needs to be in range [1, 100].");
+		
 		template <typename ... Args> using vector_type = t_vector <Args ...>;
 		template <typename ... Args> using allocator_type = t_allocator <Args ...>;
 		typedef t_key key_type;
@@ -56,12 +74,36 @@ namespace asm_lsw {
 		typedef t_access_key_fn access_key_fn_type;
 		
 		template <template <typename> class t_new_allocator>
-		using rebind_allocator = map_adaptor_phf_spec <t_vector, t_new_allocator, t_key, t_val, t_enable_serialize, t_access_key_fn>;
+		using rebind_allocator = map_adaptor_phf_spec <
+			t_vector, t_new_allocator, t_key, t_val, t_enable_serialize, t_access_key_fn,
+			t_phf_lambda, t_phf_alpha, t_phf_seed, t_compress_slots
+		>;
 		
-		enum { enable_serialize = t_enable_serialize };
+		enum {
+			enable_serialize = t_enable_serialize,
+			compress_slots = t_compress_slots
+		};
+		
+		static std::size_t const phf_lambda{t_phf_lambda};
+		static std::size_t const phf_alpha{t_phf_alpha};
+		static uint32_t const phf_seed{t_phf_seed};
 	};
 	
 	
+	// Minimal perfect hashing: the PHF loading factor is 100 % and the slots are compressed.
+	template <
+		template <typename ...> class t_vector,
+		template <typename> class t_allocator,
+		typename t_key,
+		typename t_val,
+		bool t_enable_serialize = false,
+		typename t_access_key_fn = map_adaptor_access_key <t_key>
+	>
+	using map_adaptor_mphf_spec = map_adaptor_phf_spec <
+		t_vector, t_allocator, t_key, t_val, t_enable_serialize, t_access_key_fn, 4, 100, 0, true
+	>;
+	
+	
 	template <typename t_spec>
 	class map_adaptor_phf_base
 	{
@@ -164,7 +206,7 @@ namespace asm_lsw {
 			m_adaptor(adaptor),
 			m_idx(idx)
 		{
-			if (convert && adaptor->m_vector.size())
+			if (convert && adaptor->m_vector.size() && !t_adaptor::compress_slots)
 			{
 				auto const next(m_adaptor->m_used_indices_select1_support(1 + idx));
 				m_idx = next;
@@ -232,6 +274,9 @@ namespace asm_lsw {
 		
 		template <typename t_map, typename t_access_value_fn = detail::map_adaptor_phf_access_value <t_spec>>
 		using builder_type = map_adaptor_phf_builder <t_spec, t_map, t_access_value_fn>;
+		
+		template <typename t_map, typename t_access_value_fn = detail::map_adaptor_phf_access_value <t_spec>>
+		using parallel_builder_type = map_adaptor_phf_parallel_builder <t_spec, t_map, t_access_value_fn>;
 
 		typedef typename base_class::access_key_fn_type					access_key_fn_type;
 		typedef typename access_key_fn_type::accessed_type				accessed_type;
@@ -243,6 +288,11 @@ namespace asm_lsw {
 		using mutable_map_adaptor_type = map_adaptor <t_map, key_type, value_type, access_key_fn_type, t_hash, t_key_equal>;
 		
 		typedef detail::map_adaptor_phf_tag		map_adaptor_phf_tag;
+		
+		enum { compress_slots = t_spec::compress_slots };
+		
+		// Number of keys hashed before their slots are checked in find_many.
+		static std::size_t const s_find_many_batch_size{8};
 
 		static_assert(
 			std::is_same <typename access_key_fn_type::key_type, key_type>::value,
@@ -269,6 +319,15 @@ namespace asm_lsw {
 			t_adaptor &adaptor,
 			accessed_type const &key
 		);
+		
+		// Number of possible hash values.
+		size_type hash_range() const { return this->m_used_indices.size() ? this->m_used_indices.size() - 1 : 0; }
+		
+		size_type slot_index(size_type const adapted_key) const;
+		size_type check_slot(accessed_type const &acc, size_type const idx) const;
+		size_type check_index(accessed_type const &acc, size_type const adapted_key) const { return check_slot(acc, slot_index(adapted_key)); }
+		void fill_unused_slots();
+		void setup_support();
 			
 		size_type serialize_common(std::ostream &out, sdsl::structure_tree_node *child) const;
 		void load_common(std::istream &in);
@@ -289,6 +348,7 @@ namespace asm_lsw {
 		map_adaptor_phf(
 			t_map &map,
 			std::size_t const size,
+			std::size_t const hash_range,
 			phf_wrapper &phf,
 			allocator_type const &alloc,
 			access_key_fn_type const &access_key_fn,
@@ -334,6 +394,20 @@ namespace asm_lsw {
 		const_iterator cend() const								{ return const_iterator(this, this->m_vector.size()); }
 		kv_type const &operator[](size_type const idx) const	{ return this->m_vector[idx]; }
 		
+		// Find the indices of the elements that correspond to the given keys. map().size() is
+		// stored for the keys that were not found. The keys are handled in batches s.t. the hash
+		// values are calculated first and the slots are checked only after that, which lets the
+		// memory accesses of the different keys overlap.
+		template <typename t_key_it, typename t_index_it>
+		void find_many(t_key_it keys_it, t_key_it const keys_end, t_index_it indices_it) const;
+		
+		template <typename t_keys, typename t_indices>
+		void find_many(t_keys const &keys, t_indices &indices) const
+		{
+			indices.resize(keys.size());
+			find_many(keys.cbegin(), keys.cend(), indices.begin());
+		}
+		
 		// Enable _keys variants if the container is a set-type. For load and serialize,
 		// require enable_serialize since implementing the required function in value_type
 		// and possibly access_key_fn might not be trivial.
@@ -391,7 +465,8 @@ namespace asm_lsw {
 		allocator_type			m_allocator;	// FIXME: always copy?
 		access_key_fn_type		m_access_key_fn;	// FIXME: always copy?
 		t_access_value_fn		m_access_value_fn;	// FIXME: add a constructor parameter for this.
-		std::size_t				m_element_count{0};
+		std::size_t				m_element_count{0};	// Number of slots.
+		std::size_t				m_hash_range{0};
 		t_map					&m_map;
 		
 	public:
@@ -412,6 +487,11 @@ namespace asm_lsw {
 			return m_element_count;
 		}
 		
+		std::size_t hash_range() const
+		{
+			return m_hash_range;
+		}
+		
 		phf_wrapper &phf() { return m_phf; }
 		allocator_type &allocator() { return m_allocator; }
 		t_map &map() { return m_map; }
@@ -451,6 +531,34 @@ namespace asm_lsw {
 	};
 	
 	
+	// Calls access_value_fn for the elements of the given map in parallel before
+	// constructing the PHF. This is useful when the values are expensive to construct,
+	// e.g. when they are compact tries that have PHFs of their own. Since the
+	// builder refers to the transformed values, the object may not be copied or moved.
+	template <typename t_spec, typename t_map, typename t_access_value_fn = detail::map_adaptor_phf_access_value <t_spec>>
+	class map_adaptor_phf_parallel_builder
+	{
+	public:
+		typedef map_adaptor_phf <t_spec>						adaptor_type;
+		typedef typename adaptor_type::kv_type					kv_type;
+		typedef std::vector <kv_type>							value_vector_type;
+		typedef map_adaptor_phf_builder <t_spec, value_vector_type>	builder_type;
+		
+	protected:
+		value_vector_type				m_values;
+		std::unique_ptr <builder_type>	m_builder;
+		
+	public:
+		// Use hardware_concurrency threads if thread_count is zero.
+		explicit map_adaptor_phf_parallel_builder(t_map &map, std::size_t const thread_count = 0);
+		map_adaptor_phf_parallel_builder(map_adaptor_phf_parallel_builder const &) = delete;
+		map_adaptor_phf_parallel_builder &operator=(map_adaptor_phf_parallel_builder const &) & = delete;
+		
+		builder_type &builder() { return *m_builder; }
+		std::size_t element_count() const { return m_builder->element_count(); }
+	};
+	
+	
 	template <
 		typename t_spec,
 		template <typename ...> class t_map,
@@ -505,6 +613,13 @@ namespace asm_lsw {
 	void map_iterator_phf_tpl <t_adaptor, t_it_val>::advance(difference_type n)
 	{
 		assert(m_adaptor);
+		
+		// The slots are in object order if they have been compressed.
+		if (t_adaptor::compress_slots)
+		{
+			m_idx += n;
+			return;
+		}
 
 		// Convert from vector index to object order and advance.
 		auto const idx(m_idx - m_adaptor->m_used_indices_rank0_support(m_idx));
@@ -561,14 +676,103 @@ namespace asm_lsw {
 		// To alleviate this, check both that a value has been stored for the adapted key and that the
 		// found value matches the given one.
 		auto const adapted_key(adaptor.adapted_key(acc));
-		if (adapted_key < adaptor.m_vector.size() && adaptor.m_used_indices[adapted_key])
+		return adaptor.check_index(acc, adapted_key);
+	}
+	
+	
+	// Return the slot for the given hash value or m_vector.size() if there is none.
+	template <typename t_spec>
+	auto map_adaptor_phf <t_spec>::slot_index(size_type const adapted_key) const -> size_type
+	{
+		if (! (adapted_key < hash_range()))
+			return this->m_vector.size();
+		
+		// With compressed slots, the slot is the one of the next used index. Since the element
+		// in it has been stored with a different hash value if adapted_key is not in use,
+		// the keys will not match in check_slot.
+		if (compress_slots)
+			return adapted_key - m_used_indices_rank0_support(adapted_key);
+		
+		return adapted_key;
+	}
+	
+	
+	// Check the slot without consulting m_used_indices; see fill_unused_slots().
+	template <typename t_spec>
+	auto map_adaptor_phf <t_spec>::check_slot(accessed_type const &acc, size_type const idx) const -> size_type
+	{
+		if (idx < this->m_vector.size())
 		{
-			auto const found_acc(adaptor.m_access_key_fn(trait_type::key(adaptor.m_vector[adapted_key])));
+			auto const found_acc(this->m_access_key_fn(trait_type::key(this->m_vector[idx])));
 			if (found_acc == acc)
-				return adapted_key;
+				return idx;
 		}
+		
+		return this->m_vector.size();
+	}
+	
+	
+	template <typename t_spec>
+	template <typename t_key_it, typename t_index_it>
+	void map_adaptor_phf <t_spec>::find_many(t_key_it keys_it, t_key_it const keys_end, t_index_it indices_it) const
+	{
+		std::array <accessed_type, s_find_many_batch_size> accs;
+		std::array <size_type, s_find_many_batch_size> slots;
+		auto const vector_size(this->m_vector.size());
+		
+		while (keys_it != keys_end)
+		{
+			// The hash values do not depend on each other.
+			std::size_t count(0);
+			while (count < s_find_many_batch_size && keys_it != keys_end)
+			{
+				accs[count] = this->m_access_key_fn(*keys_it);
+				slots[count] = adapted_key(accs[count]);
+				++keys_it;
+				++count;
+			}
+			
+			// Request the slots before reading any of them.
+			for (std::size_t i(0); i < count; ++i)
+			{
+				auto const idx(slot_index(slots[i]));
+				slots[i] = idx;
+				if (idx < vector_size)
+					util::prefetch(&this->m_vector[idx]);
+			}
 			
-		return adaptor.m_vector.size();
+			for (std::size_t i(0); i < count; ++i)
+			{
+				*indices_it = check_slot(accs[i], slots[i]);
+				++indices_it;
+			}
+		}
+	}
+	
+	
+	// Store the key of some element to the unused slots. Since the element is stored in another
+	// slot, the hash of the key (or the key itself if the PHF is not used) differs from the index
+	// of any unused slot. Hence a key that is compared to an unused slot cannot match, and the
+	// lookups only need to read the g array of the PHF and the slot instead of also m_used_indices.
+	template <typename t_spec>
+	void map_adaptor_phf <t_spec>::fill_unused_slots()
+	{
+		// Compressed slots are all in use.
+		if (compress_slots || 0 == this->m_size)
+			return;
+		
+		auto const count(this->m_vector.size());
+		size_type first(0);
+		while (!this->m_used_indices[first])
+			++first;
+		
+		assert(first < count);
+		auto const key(trait_type::key(this->m_vector[first]));
+		for (size_type i(0); i < count; ++i)
+		{
+			if (!this->m_used_indices[i])
+				trait_type::set_key(this->m_vector[i], key);
+		}
 	}
 	
 	
@@ -668,7 +872,7 @@ namespace asm_lsw {
 		m_used_indices_rank0_support.set_vector(&this->m_used_indices);
 		m_used_indices_select1_support.set_vector(&this->m_used_indices);
 		
-		this->m_vector.resize(this->m_used_indices.size() - 1);
+		this->m_vector.resize(compress_slots ? this->m_size : hash_range());
 	}
 	
 	
@@ -685,7 +889,7 @@ namespace asm_lsw {
 		size_type written_bytes(0);
 
 		written_bytes += serialize_common(out, child);
-		written_bytes += trait_type::serialize_keys(this->m_vector, this->m_used_indices, value_callback, out, child);
+		written_bytes += trait_type::serialize_keys(this->m_vector, this->m_used_indices, compress_slots, value_callback, out, child);
 		
 		sdsl::structure_tree::add_size(child, written_bytes);
 		return written_bytes;
@@ -704,7 +908,7 @@ namespace asm_lsw {
 		size_type written_bytes(0);
 
 		written_bytes += serialize_common(out, child);
-		written_bytes += trait_type::serialize(this->m_vector, this->m_used_indices, out, child);
+		written_bytes += trait_type::serialize(this->m_vector, this->m_used_indices, compress_slots, out, child);
 		
 		sdsl::structure_tree::add_size(child, written_bytes);
 		return written_bytes;
@@ -719,7 +923,8 @@ namespace asm_lsw {
 	) -> typename std::enable_if <trait_type::is_map_type && t_dummy>::type
 	{
 		load_common(in);
-		trait_type::load_keys(this->m_vector, this->m_used_indices, value_callback, in);
+		trait_type::load_keys(this->m_vector, this->m_used_indices, compress_slots, value_callback, in);
+		fill_unused_slots();
 	}
 	
 	
@@ -730,7 +935,8 @@ namespace asm_lsw {
 	) -> typename std::enable_if <t_spec::enable_serialize && t_dummy>::type
 	{
 		load_common(in);
-		trait_type::load(this->m_vector, this->m_used_indices, in);
+		trait_type::load(this->m_vector, this->m_used_indices, compress_slots, in);
+		fill_unused_slots();
 	}
 	
 	
@@ -753,6 +959,7 @@ namespace asm_lsw {
 		map_adaptor_phf(
 			builder.map(),
 			builder.element_count(),
+			builder.hash_range(),
 			builder.phf(),
 			builder.allocator(),
 			builder.access_key_fn(),
@@ -767,6 +974,7 @@ namespace asm_lsw {
 	map_adaptor_phf <t_spec>::map_adaptor_phf(
 		t_map &map,
 		std::size_t size,
+		std::size_t hash_range,
 		phf_wrapper &phf,
 		allocator_type const &alloc,
 		access_key_fn_type const &access_key_fn,
@@ -778,9 +986,9 @@ namespace asm_lsw {
 			// Reserve the required space for m_used_indices.
 			// Make select1(count) return a value that may be used in the end() itearator.
 			{
-				assert(size < 1 + size);
-				decltype(this->m_used_indices) tmp(1 + size, 0);
-				tmp[size] = 1;
+				assert(hash_range < 1 + hash_range);
+				decltype(this->m_used_indices) tmp(1 + hash_range, 0);
+				tmp[hash_range] = 1;
 				this->m_used_indices = std::move(tmp);
 			}
 			
@@ -789,8 +997,31 @@ namespace asm_lsw {
 			// FIXME: since the template parameter of PHF::hash is independent of that of PHF::init,
 			// the function may return incorrect hashes thus making its use rather error-prone.
 			// For now, using the same type with PHF::init and adapted_key() needs to be ensured.
+			if (compress_slots)
+			{
+				// The slot of an element depends on the other elements' hash values,
+				// so mark the used indices first.
+				for (auto const &kv : map)
+				{
+					auto const hash(this->adapted_key(this->m_access_key_fn(trait_type::key(kv))));
+					assert(!this->m_used_indices[hash]);
+					this->m_used_indices[hash] = 1;
+				}
+				
+				setup_support();
+				
+				for (auto &kv : map)
+				{
+					auto const hash(this->adapted_key(this->m_access_key_fn(trait_type::key(kv))));
+					auto const idx(slot_index(hash));
+					assert(idx < size);
+					
+					this->m_vector[idx] = std::move(access_value_fn(kv));
+					++this->m_size;
+				}
+			}
+			else
 			{
-				auto const map_size(map.size());
 				for (auto &kv : map)
 				{
 					auto const key(this->m_access_key_fn(trait_type::key(kv)));
@@ -801,19 +1032,27 @@ namespace asm_lsw {
 					this->m_used_indices[hash] = 1;
 					++this->m_size;
 				}
+				
+				setup_support();
+				fill_unused_slots();
 			}
-			
-			// Set up rank0 support.
-			{
-				decltype(m_used_indices_rank0_support) tmp(&this->m_used_indices);
-				m_used_indices_rank0_support = std::move(tmp);
-			}
-			
-			// Set up select1 support.
-			{
-				decltype(m_used_indices_select1_support) tmp(&this->m_used_indices);
-				m_used_indices_select1_support = std::move(tmp);
-			}
+		}
+	}
+	
+	
+	template <typename t_spec>
+	void map_adaptor_phf <t_spec>::setup_support()
+	{
+		// Set up rank0 support.
+		{
+			decltype(m_used_indices_rank0_support) tmp(&this->m_used_indices);
+			m_used_indices_rank0_support = std::move(tmp);
+		}
+		
+		// Set up select1 support.
+		{
+			decltype(m_used_indices_select1_support) tmp(&this->m_used_indices);
+			m_used_indices_select1_support = std::move(tmp);
 		}
 	}
 	
@@ -862,6 +1101,34 @@ namespace asm_lsw {
 	}
 
 
+	template <typename t_spec, typename t_map, typename t_access_value_fn>
+	map_adaptor_phf_parallel_builder <t_spec, t_map, t_access_value_fn>::map_adaptor_phf_parallel_builder(
+		t_map &map,
+		std::size_t const thread_count
+	)
+	{
+		// Store the iterators to be able to process the elements in any order.
+		typedef decltype(map.begin()) iterator_type;
+		std::vector <iterator_type> iterators;
+		iterators.reserve(map.size());
+		for (auto it(map.begin()), end(map.end()); it != end; ++it)
+			iterators.push_back(it);
+		
+		// The current arena is set per thread, so make the caller's arena current in each
+		// of the worker threads for the transformed values.
+		auto const arena(pool_allocator_arena::current());
+		m_values.resize(iterators.size());
+		util::parallel_for(iterators.size(), thread_count, [this, &iterators, &arena](std::size_t const i){
+			pool_allocator_arena::scope arena_scope(arena);
+			t_access_value_fn access_value_fn;
+			m_values[i] = access_value_fn(*iterators[i]);
+		});
+		
+		// The transformed values are moved to the adaptor.
+		m_builder.reset(new builder_type(m_values));
+	}
+
+
 	template <typename t_spec, typename t_map, typename t_access_value_fn>
 	void map_adaptor_phf_builder <t_spec, t_map, t_access_value_fn>::post_init(
 		t_map &map, bool const call_post_init_map, bool const create_allocator
@@ -883,10 +1150,13 @@ namespace asm_lsw {
 		sdsl::int_vector <0> keys(map.size(), 0, std::numeric_limits <key_type>::digits);
 		fill_with_map_keys(keys, map, max_value);
 		
-		// FIXME: consider the parameters below (4, 80, 0).
-		std::size_t const loading_factor(80);
 		int st(PHF::init <key_type, false>(
-			&this->m_phf.get(), reinterpret_cast <key_type *>(keys.data()), keys.size(), 4, loading_factor, 0
+			&this->m_phf.get(),
+			reinterpret_cast <key_type *>(keys.data()),
+			keys.size(),
+			t_spec::phf_lambda,
+			t_spec::phf_alpha,
+			t_spec::phf_seed
 		));
 		assert(0 == st); // FIXME: throw instead on error. (Or do this in a wrapper for phf.)
 		
@@ -897,13 +1167,16 @@ namespace asm_lsw {
 		// skip hashing.
 		if (max_value < 1 + max_value && 1 + max_value <= m_phf.get().m)
 		{
-			m_element_count = 1 + max_value;
+			m_hash_range = 1 + max_value;
 			m_phf = phf_wrapper();
 		}
 		else
 		{
-			m_element_count = m_phf.get().m;
+			m_hash_range = m_phf.get().m;
 		}
+		
+		// Compressed slots are allocated only for the elements.
+		m_element_count = (t_spec::compress_slots ? map.size() : m_hash_range);
 
 		if (create_allocator)
 		{
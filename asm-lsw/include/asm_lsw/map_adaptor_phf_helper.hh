@@ -46,6 +46,26 @@ namespace asm_lsw { namespace detail {
 	};
 	
 	
+	// Call fn with the index of the slot of each used index in order. The slots
+	// are in the same order as the used indices if they have been compressed.
+	template <typename t_used_indices, typename Fn>
+	void map_adaptor_phf_for_each_used_slot(t_used_indices const &used_indices, bool const compressed, Fn &&fn)
+	{
+		if (0 == used_indices.size())
+			return;
+		
+		typename t_used_indices::size_type j(0);
+		for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
+		{
+			if (used_indices[i])
+			{
+				fn(compressed ? j : i);
+				++j;
+			}
+		}
+	}
+	
+	
 	// Specialize when t_value = void.
 	template <typename t_spec, bool t_value_is_void = std::is_void <typename t_spec::value_type>::value>
 	struct map_adaptor_phf_trait
@@ -68,6 +88,11 @@ namespace asm_lsw { namespace detail {
 		{
 			return kv;
 		}
+		
+		static void set_key(kv_type &kv, key_type const &key)
+		{
+			kv = key;
+		}
 
 		template <typename t_kv>
 		static kv_type kv(t_kv &kv)
@@ -99,6 +124,7 @@ namespace asm_lsw { namespace detail {
 		static std::size_t serialize(
 			t_vector const &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			std::ostream &out,
 			sdsl::structure_tree_node *v
 		)
@@ -106,11 +132,9 @@ namespace asm_lsw { namespace detail {
 			std::size_t written_bytes(0);
 			
 			sdsl::structure_tree_node* node(sdsl::structure_tree::add_child(v, "keys", ""));
-			for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
-			{
-				if (used_indices[i])
-					written_bytes += sdsl::write_member_nn(vector[i], out);
-			}
+			map_adaptor_phf_for_each_used_slot(used_indices, compressed, [&](std::size_t const idx){
+				written_bytes += sdsl::write_member_nn(vector[idx], out);
+			});
 			
 			sdsl::structure_tree::add_size(node, written_bytes);
 			
@@ -121,41 +145,39 @@ namespace asm_lsw { namespace detail {
 		static std::size_t serialize_keys(
 			t_vector const &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			Fn value_callback,
 			std::ostream &out,
 			sdsl::structure_tree_node *v
 		)
 		{
-			return serialize(vector, used_indices, out, v);
+			return serialize(vector, used_indices, compressed, out, v);
 		}
 		
 		template <typename t_vector, typename t_used_indices>
 		static void load(
-			t_vector const &vector,
+			t_vector &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			std::istream &in
 		)
 		{
-			for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
-			{
-				assert(i < used_indices.size());
-				if (used_indices[i])
-				{
-					assert(i < vector.size());
-					sdsl::read_member(vector[i], in);
-				}
-			}
+			map_adaptor_phf_for_each_used_slot(used_indices, compressed, [&](std::size_t const idx){
+				assert(idx < vector.size());
+				sdsl::read_member(vector[idx], in);
+			});
 		}
 		
 		template <typename t_vector, typename t_used_indices, typename Fn>
 		static void load_keys(
 			t_vector &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			Fn value_callback,
 			std::istream &in
 		)
 		{
-			load(vector, used_indices, in);
+			load(vector, used_indices, compressed, in);
 		}
 	};
 
@@ -175,6 +197,11 @@ namespace asm_lsw { namespace detail {
 		{
 			return kv.first;
 		}
+		
+		static void set_key(kv_type &kv, key_type const &key)
+		{
+			kv.first = key;
+		}
 
 		template <typename t_kv>
 		static kv_type kv(t_kv &kv)
@@ -212,6 +239,7 @@ namespace asm_lsw { namespace detail {
 		static std::size_t serialize_keys(
 			t_vector const &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			Fn value_callback,
 			std::ostream &out,
 			sdsl::structure_tree_node *v
@@ -223,17 +251,13 @@ namespace asm_lsw { namespace detail {
 			sdsl::structure_tree_node *node_keys(sdsl::structure_tree::add_child(v, "keys", ""));
 			sdsl::structure_tree_node *node_values(sdsl::structure_tree::add_child(v, "values", ""));
 			
-			for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
-			{
-				if (used_indices[i])
-					size_keys += sdsl::write_member_nn(vector[i].first, out);
-			}
+			map_adaptor_phf_for_each_used_slot(used_indices, compressed, [&](std::size_t const idx){
+				size_keys += sdsl::write_member_nn(vector[idx].first, out);
+			});
 			
-			for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
-			{
-				if (used_indices[i])
-					size_values += value_callback(vector[i].second, out, node_values);
-			}
+			map_adaptor_phf_for_each_used_slot(used_indices, compressed, [&](std::size_t const idx){
+				size_values += value_callback(vector[idx].second, out, node_values);
+			});
 			
 			sdsl::structure_tree::add_size(node_keys, size_keys);
 			sdsl::structure_tree::add_size(node_values, size_values);
@@ -246,6 +270,7 @@ namespace asm_lsw { namespace detail {
 		static std::size_t serialize(
 			t_vector const &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			std::ostream &out,
 			sdsl::structure_tree_node *v
 		)
@@ -255,42 +280,34 @@ namespace asm_lsw { namespace detail {
 				return serialize_value(value, out, node);
 			};
 			
-			return serialize_keys(vector, used_indices, cb, out, v);
+			return serialize_keys(vector, used_indices, compressed, cb, out, v);
 		}
 		
 		template <typename t_vector, typename t_used_indices, typename Fn>
 		static void load_keys(
 			t_vector &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			Fn value_callback,
 			std::istream &in
 		)
 		{
-			for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
-			{
-				assert(i < used_indices.size());
-				if (used_indices[i])
-				{
-					assert(i < vector.size());
-					sdsl::read_member(vector[i].first, in);
-				}
-			}
+			map_adaptor_phf_for_each_used_slot(used_indices, compressed, [&](std::size_t const idx){
+				assert(idx < vector.size());
+				sdsl::read_member(vector[idx].first, in);
+			});
 			
-			for (typename t_used_indices::size_type i(0), count(used_indices.size() - 1); i < count; ++i)
-			{
-				assert(i < used_indices.size());
-				if (used_indices[i])
-				{
-					assert(i < vector.size());
-					value_callback(vector[i].second, in);
-				}
-			}
+			map_adaptor_phf_for_each_used_slot(used_indices, compressed, [&](std::size_t const idx){
+				assert(idx < vector.size());
+				value_callback(vector[idx].second, in);
+			});
 		}
 		
 		template <typename t_vector, typename t_used_indices>
 		static void load(
 			t_vector &vector,
 			t_used_indices const &used_indices,
+			bool const compressed,
 			std::istream &in
 		)
 		{
@@ -299,7 +316,7 @@ namespace asm_lsw { namespace detail {
 				return load_value(value, in);
 			};
 			
-			return load_keys(vector, used_indices, cb, in);
+			return load_keys(vector, used_indices, compressed, cb, in);
 		}
 	};
 	
@@ -0,0 +1,136 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#ifndef ASM_LSW_MEMORY_POLICY_HH
+#define ASM_LSW_MEMORY_POLICY_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <utility>
+#include <vector>
+
+
+namespace asm_lsw {
+	
+	enum class huge_page_policy : uint8_t
+	{
+		none,
+		transparent,	// Advise the kernel to use transparent huge pages for the tries.
+		explicit_pages	// Also allocate the SDSL data structures from reserved huge pages
+						// (for the rest of the process, see memory_policy_scope).
+	};
+	
+	
+	enum class numa_policy : uint8_t
+	{
+		none,
+		interleave		// Spread the pages over the online NUMA nodes.
+	};
+	
+	
+	namespace detail {
+		
+		// Record the memory passed to the stream instead of copying it. SDSL serializes
+		// the contents of an int_vector directly from its data, so the recorded ranges
+		// cover the vectors of the serialized data structure.
+		class address_range_streambuf : public std::streambuf
+		{
+		public:
+			typedef std::pair <uintptr_t, uintptr_t>	range_type;	// [first, second)
+			
+		protected:
+			std::vector <range_type>	m_ranges;
+			
+		public:
+			// Contiguous writes are merged into one range.
+			std::vector <range_type> const &ranges() const { return m_ranges; }
+			
+		protected:
+			virtual int_type overflow(int_type c) override;
+			virtual std::streamsize xsputn(char const *s, std::streamsize n) override;
+		};
+	}
+	
+	
+	// Control the placement of the data structures that are constructed or loaded
+	// by the calling thread while the object exists. Once loaded, the index is read
+	// by all the worker threads, so spreading it over the NUMA nodes balances the
+	// memory traffic and huge pages reduce the TLB misses caused by random access.
+	// explicit_pages calls sdsl::memory_manager::use_hugepages(), which cannot be undone,
+	// so SDSL keeps allocating from the reserved huge pages for the rest of the process
+	// even after the scope has been destroyed; only the setting of the arenas is restored.
+	// With transparent, the pool allocator arenas are advised when their blocks are
+	// allocated; the SDSL data structures are allocated with malloc and need to be
+	// advised with advise_loaded_memory() after loading. Only the memory owned by the
+	// given data structures is advised. The index is interleaved but not replicated to
+	// each NUMA node.
+	class memory_policy_scope
+	{
+	protected:
+		huge_page_policy m_huge_page_policy{huge_page_policy::none};
+		bool m_previous_huge_pages{false};
+		bool m_huge_pages_enabled{false};
+		bool m_numa_policy_set{false};
+		
+	public:
+		memory_policy_scope(huge_page_policy const hp, numa_policy const np);
+		~memory_policy_scope();
+		memory_policy_scope(memory_policy_scope const &) = delete;
+		memory_policy_scope &operator=(memory_policy_scope const &) & = delete;
+		
+		// Return false if the requested policy could not be applied.
+		bool huge_pages_enabled() const { return m_huge_pages_enabled; }
+		bool numa_policy_set() const { return m_numa_policy_set; }
+		
+		// Advise the kernel to back the whole huge pages within the given range with
+		// transparent huge pages if the policy is transparent. Return true if any were advised.
+		bool advise_range(void const *addr, std::size_t const size) const;
+		
+		// Advise the int_vectors of the given data structure, e.g. a loaded CST, that take
+		// at least min_size bytes. The vectors are found by serializing the data structure
+		// with detail::address_range_streambuf. Return the number of ranges advised.
+		template <typename t_ds>
+		std::size_t advise_loaded_memory(t_ds const &ds, std::size_t const min_size = s_huge_page_size) const;
+		
+		static std::size_t const s_huge_page_size{std::size_t(2) << 20};
+	};
+	
+	
+	template <typename t_ds>
+	std::size_t memory_policy_scope::advise_loaded_memory(t_ds const &ds, std::size_t const min_size) const
+	{
+		// The explicitly reserved huge pages do not need to be advised.
+		if (! (m_huge_pages_enabled && huge_page_policy::transparent == m_huge_page_policy))
+			return 0;
+		
+		detail::address_range_streambuf buf;
+		std::ostream stream(&buf);
+		ds.serialize(stream);
+		
+		std::size_t retval(0);
+		for (auto const &range : buf.ranges())
+		{
+			auto const size(range.second - range.first);
+			if (min_size <= size && advise_range(reinterpret_cast <void const *>(range.first), size))
+				++retval;
+		}
+		return retval;
+	}
+}
+
+#endif
@@ -17,9 +17,13 @@
 #ifndef ASM_LSW_STATIC_ALLOCATOR_HH
 #define ASM_LSW_STATIC_ALLOCATOR_HH
 
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 
 namespace asm_lsw {
@@ -63,12 +67,99 @@ namespace asm_lsw {
 }
 
 
+namespace asm_lsw {
+	
+	// Memory shared by the pool allocators of one index. The space is reserved in large
+	// blocks and handed out with a bump pointer; nothing is returned to the system before
+	// the arena is destroyed, and only the most recent allocation may be reused after it
+	// has been deallocated. While a pool_allocator_arena::scope exists, new pools and
+	// default-constructed pool_allocators created on the same thread take their memory
+	// from the scope's arena. The allocators keep the arena alive. The current arena is
+	// set per thread but one arena may be used from multiple threads.
+	class pool_allocator_arena
+	{
+	public:
+		class scope;
+		
+	protected:
+		struct free_deleter
+		{
+			void operator()(unsigned char *ptr) const { free(ptr); }
+		};
+		
+		typedef std::unique_ptr <unsigned char, free_deleter> block_ptr;
+		
+		struct block
+		{
+			block_ptr ptr;
+			std::size_t size{0};
+			std::size_t used{0};
+		};
+		
+	protected:
+		std::vector <block> m_blocks;
+		std::mutex m_mutex;
+		std::size_t m_block_size{0};
+		std::size_t m_bytes_used{0};
+		bool m_huge_pages{false};
+		
+	protected:
+		static std::shared_ptr <pool_allocator_arena> &current_ptr();
+		block &add_block(std::size_t size, bool const dedicated);
+		
+	public:
+		static std::size_t const s_default_block_size{std::size_t(32) << 20};
+		static std::size_t const s_huge_page_size{std::size_t(2) << 20};
+		
+		// If huge_pages is true, the blocks are aligned to and sized in multiples of
+		// s_huge_page_size and the kernel is advised to back them with transparent huge pages.
+		// By default, the setting from set_huge_pages_by_default() is used.
+		explicit pool_allocator_arena(std::size_t block_size = s_default_block_size);
+		pool_allocator_arena(std::size_t block_size, bool huge_pages);
+		pool_allocator_arena(pool_allocator_arena const &) = delete;
+		pool_allocator_arena &operator=(pool_allocator_arena const &) & = delete;
+		
+		static std::shared_ptr <pool_allocator_arena> current();
+		static bool huge_pages_by_default();
+		static void set_huge_pages_by_default(bool huge_pages);
+		
+		// Total number of bytes allocated by the pools and the pool_allocators while
+		// no arena was current, e.g. on threads that did not open a scope.
+		static std::size_t bytes_allocated_without_arena();
+		static void add_bytes_allocated_without_arena(std::size_t size);
+		
+		unsigned char *allocate_bytes(std::size_t size, std::size_t alignment);
+		void deallocate_bytes(unsigned char *ptr, std::size_t size);
+		
+		std::size_t block_count();
+		std::size_t bytes_reserved();
+		std::size_t bytes_used();
+	};
+	
+	
+	// Make an arena current on the calling thread for the lifetime of the object.
+	class pool_allocator_arena::scope
+	{
+	protected:
+		std::shared_ptr <pool_allocator_arena> m_previous;
+		
+	public:
+		explicit scope(std::shared_ptr <pool_allocator_arena> const &arena);
+		~scope();
+		scope(scope const &) = delete;
+		scope &operator=(scope const &) & = delete;
+	};
+}
+
+
 namespace asm_lsw { namespace detail {
 	
 	class pool_allocator_impl
 	{
 	protected:
-		std::unique_ptr <unsigned char[]> m_ptr{};
+		std::unique_ptr <unsigned char[]> m_ptr{};	// Owned memory if not allocated from an arena.
+		std::shared_ptr <pool_allocator_arena> m_arena{};
+		unsigned char *m_data{nullptr};
 		std::size_t m_n{0};			// Total space in bytes.
 		std::size_t m_idx{0};		// Next available byte.
 		
@@ -91,19 +182,27 @@ namespace asm_lsw { namespace detail {
 		
 		bool operator==(pool_allocator_impl const &other) const
 		{
-			return m_ptr.get() == other.m_ptr.get();
+			return m_data == other.m_data;
 		}
 		
 		template <typename t_element>
 		void allocate_pool_bytes(std::size_t size)
 		{
-			assert(!m_ptr.get());
-
-			m_ptr.reset(
-				reinterpret_cast <unsigned char *> (
-					new std::aligned_storage <1, alignof(t_element)>[size]
-				)
-			);
+			assert(!m_data);
+			
+			m_arena = pool_allocator_arena::current();
+			if (m_arena)
+				m_data = m_arena->allocate_bytes(size, alignof(t_element));
+			else
+			{
+				pool_allocator_arena::add_bytes_allocated_without_arena(size);
+				m_ptr.reset(
+					reinterpret_cast <unsigned char *> (
+						new std::aligned_storage <1, alignof(t_element)>[size]
+					)
+				);
+				m_data = m_ptr.get();
+			}
 			
 			m_n = size;
 			m_idx = 0;
@@ -118,8 +217,10 @@ namespace asm_lsw { namespace detail {
 		
 		void destroy_pool()
 		{
-			assert(m_ptr.get());
+			assert(m_data);
 			m_ptr.reset(nullptr);
+			m_arena.reset();
+			m_data = nullptr;
 			m_n = 0;
 			m_idx = 0;
 		}
@@ -128,7 +229,7 @@ namespace asm_lsw { namespace detail {
 		unsigned char *allocate(std::size_t n)
 		{
 			// Make sure that the pointer is aligned properly.
-			uintptr_t const start(reinterpret_cast <uintptr_t>(m_ptr.get()));
+			uintptr_t const start(reinterpret_cast <uintptr_t>(m_data));
 			uintptr_t const addr(start + m_idx);
 			std::size_t size{0}, add{0};
 			space_requirement::bytes_from_address <t_element>(addr, n, size, add);
@@ -137,7 +238,7 @@ namespace asm_lsw { namespace detail {
 			if (m_idx + add + size <= m_n)
 			{
 				m_idx += add;
-				unsigned char *retval(m_ptr.get() + m_idx);
+				unsigned char *retval(m_data + m_idx);
 				m_idx += size;
 				return retval;
 			}
@@ -179,16 +280,18 @@ namespace asm_lsw {
 		
 	protected:
 		std::shared_ptr <detail::pool_allocator_impl> m_a;
+		std::shared_ptr <pool_allocator_arena> m_arena;	// Used if m_a is null.
 		
 	public:
-		// Use std::allocator by default in order to get a working allocator with
-		// the default constructor.
+		// Use the current arena or std::allocator by default in order to get
+		// a working allocator with the default constructor.
 		pool_allocator(bool instantiate_empty_alloctor = false):
 			m_a(
 				instantiate_empty_alloctor ?
 				new detail::pool_allocator_impl :
 				nullptr
-			)
+			),
+			m_arena(instantiate_empty_alloctor ? nullptr : pool_allocator_arena::current())
 		{
 		}
 		
@@ -211,9 +314,10 @@ namespace asm_lsw {
 		}
 		
 		template <typename U>
-		pool_allocator(pool_allocator <U> const &other)
+		pool_allocator(pool_allocator <U> const &other):
+			m_a(other.m_a),
+			m_arena(other.m_arena)
 		{
-			m_a = other.m_a;
 		}
 		
 		pool_allocator select_on_container_copy_construction() const
@@ -227,8 +331,11 @@ namespace asm_lsw {
 			detail::pool_allocator_impl *allocator(m_a.get());
 			if (allocator)
 				return reinterpret_cast <value_type *>(allocator->allocate <value_type>(n));
+			else if (m_arena)
+				return reinterpret_cast <value_type *>(m_arena->allocate_bytes(n * sizeof(value_type), alignof(value_type)));
 			else
 			{
+				pool_allocator_arena::add_bytes_allocated_without_arena(n * sizeof(value_type));
 				std::allocator <value_type> allocator;
 				return allocator.allocate(n, hint);
 			}
@@ -236,8 +343,15 @@ namespace asm_lsw {
 		
 		void deallocate(value_type *ptr, std::size_t n)
 		{
+			// Memory from the pools and the arenas is released all at once
+			// apart from the most recent arena allocation.
 			auto *allocator(m_a.get());
-			if (!allocator)
+			if (allocator)
+				return;
+			
+			if (m_arena)
+				m_arena->deallocate_bytes(reinterpret_cast <unsigned char *>(ptr), n * sizeof(value_type));
+			else
 			{
 				std::allocator <value_type> allocator;
 				allocator.deallocate(ptr, n);
@@ -254,7 +368,7 @@ namespace asm_lsw {
 	template <typename T, typename U>
 	bool operator==(pool_allocator <T> const &a, pool_allocator <U> const &b)
 	{
-		return a.m_a == b.m_a;
+		return a.m_a == b.m_a && a.m_arena == b.m_arena;
 	}
 	
 	template <typename T, typename U>
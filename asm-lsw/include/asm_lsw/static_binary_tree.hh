@@ -80,7 +80,31 @@ namespace asm_lsw { namespace detail {
 
 namespace asm_lsw
 {
-	template <typename t_key, typename t_mapped = void, bool t_enable_serialize = false>
+	// Placement of the nodes in memory. The nodes are always addressed with their Ahnentafel
+	// (BFS) indices; the layout only determines the order in which the keys are stored.
+	// With bfs, the nodes on the deep levels are far apart and each step of a search is likely
+	// to miss the cache. veb stores the tree recursively in van Emde Boas order, i.e. a top tree
+	// of half the height followed by the bottom trees, which makes the layout cache-oblivious.
+	// blocked stores subtrees of s_block_height levels contiguously (like the nodes of a B-tree)
+	// so that a block fits in a cache line.
+	// With bfs, only the used nodes have keys and a node's key is located with a rank query,
+	// which keeps the serialized format of the earlier versions. The other layouts store the
+	// keys of the complete tree (less than twice the number of keys) so that a slot is also
+	// the position of the key.
+	enum class static_binary_tree_layout : uint8_t
+	{
+		bfs		= 0,
+		veb		= 1,
+		blocked	= 2
+	};
+	
+	
+	template <
+		typename t_key,
+		typename t_mapped = void,
+		bool t_enable_serialize = false,
+		static_binary_tree_layout t_layout = static_binary_tree_layout::bfs
+	>
 	class static_binary_tree
 	{
 		template <typename, typename, typename> friend class detail::static_binary_tree_iterator_tpl;
@@ -107,12 +131,23 @@ namespace asm_lsw
 		
 		enum { is_map_type = helper_type::is_map_type };
 		
+		// Number of levels in a block of the blocked layout.
+		static size_type const s_block_height{detail::static_binary_tree_block_height(sizeof(value_type))};
+		
+		// Trees of at most this many values are stored in sorted order and searched linearly.
+		static size_type const s_linear_search_limit{128 / sizeof(value_type)};
+		
+		// Whether the keys of the unused slots are stored, see static_binary_tree_layout.
+		static bool const s_dense_storage{static_binary_tree_layout::bfs != t_layout};
+		
 	protected:
-		helper_type						m_helper;
-		sdsl::bit_vector				m_used_indices;
-		sdsl::bit_vector::rank_1_type	m_used_indices_r1_support;
+		helper_type						m_helper;			// In layout order.
+		sdsl::bit_vector				m_used_indices;		// In layout order.
+		sdsl::bit_vector::rank_1_type	m_used_indices_r1_support;	// Only with bfs.
+		size_type						m_size{0};			// Not serialized with bfs.
 		size_type						m_leftmost_idx{0};
 		size_type						m_past_end_idx{0};
+		size_type						m_height{0};		// Not serialized.
 		
 	protected:
 		template <typename t_collection>
@@ -123,6 +158,11 @@ namespace asm_lsw
 		size_type right_child(size_type const i) const ASM_LSW_CONST { return 2 * i + 2; }
 		size_type parent(size_type const i) const ASM_LSW_CONST { return (i - 1) / 2; }
 		
+		// Position of the node in m_used_indices. With dense storage, also the position of the key.
+		size_type slot(size_type const i) const ASM_LSW_PURE;
+		size_type key_index(size_type const i) const;
+		bool is_used(size_type const i) const { return i < m_used_indices.size() && m_used_indices[slot(i)]; }
+		
 		bool left_child_c(size_type &i /* inout */) const;
 		bool right_child_c(size_type &i /* inout */) const;
 		bool parent_c(size_type &i /* inout */) const ASM_LSW_CONST;
@@ -134,7 +174,10 @@ namespace asm_lsw
 		template <typename t_vector>
 		void fill_tree(t_vector const &input_vec, size_type const target, size_type const begin, size_type const end);
 		
-		bool lower_bound_subtree(key_type const &key, size_type idx, const_iterator &it /* out */) const;
+		size_type lower_bound_idx(key_type const &key) const;
+		
+		// Small trees have no m_used_indices and the node indices are positions in the sorted order.
+		bool is_linear() const { return 0 == m_used_indices.size(); }
 		
 		size_type serialize_common(std::ostream &out, sdsl::structure_tree_node *child) const;
 		void load_common(std::istream &in);
@@ -195,7 +238,7 @@ namespace asm_lsw
 		static_binary_tree &operator=(static_binary_tree &&) &;
 		
 		bool empty() const { return 0 == size(); }
-		size_type size() const { return m_helper.size(); }
+		size_type size() const { return m_size; }
 		const_iterator find(key_type const &key) const;
 		const_iterator lower_bound(key_type const &key) const;
 		
@@ -208,9 +251,14 @@ namespace asm_lsw
 		const_reverse_iterator rbegin() const	{ return crbegin(); }
 		const_reverse_iterator rend() const		{ return crend(); }
 		
-		template <typename t_other_key, typename t_other_value, bool t_other_enable_serialize>
+		template <
+			typename t_other_key,
+			typename t_other_value,
+			bool t_other_enable_serialize,
+			static_binary_tree_layout t_other_layout
+		>
 		bool operator==(
-			static_binary_tree <t_other_key, t_other_value, t_other_enable_serialize> const &other
+			static_binary_tree <t_other_key, t_other_value, t_other_enable_serialize, t_other_layout> const &other
 		) const
 		{
 			return std::equal(cbegin(), cend(), other.cbegin(), other.cend());
@@ -247,36 +295,40 @@ namespace asm_lsw
 	
 	
 	// FIXME: most of these could be made automatic by creating a base class without the r1 support.
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	static_binary_tree <t_key, t_mapped, t_enable_serialize>::static_binary_tree (
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::static_binary_tree (
 		static_binary_tree const &other
 	):
 		m_helper(other.m_helper),
 		m_used_indices(other.m_used_indices),
 		m_used_indices_r1_support(other.m_used_indices_r1_support),
+		m_size(other.m_size),
 		m_leftmost_idx(other.m_leftmost_idx),
-		m_past_end_idx(other.m_past_end_idx)
+		m_past_end_idx(other.m_past_end_idx),
+		m_height(other.m_height)
 	{
 		m_used_indices_r1_support.set_vector(&this->m_used_indices);
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	static_binary_tree <t_key, t_mapped, t_enable_serialize>::static_binary_tree (
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::static_binary_tree (
 		static_binary_tree &&other
 	):
 		m_helper(std::move(other.m_helper)),
 		m_used_indices(std::move(other.m_used_indices)),
 		m_used_indices_r1_support(std::move(other.m_used_indices_r1_support)),
+		m_size(std::move(other.m_size)),
 		m_leftmost_idx(std::move(other.m_leftmost_idx)),
-		m_past_end_idx(std::move(other.m_past_end_idx))
+		m_past_end_idx(std::move(other.m_past_end_idx)),
+		m_height(std::move(other.m_height))
 	{
 		m_used_indices_r1_support.set_vector(&this->m_used_indices);
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::operator=(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::operator=(
 		static_binary_tree const &other
 	) & -> static_binary_tree &
 	{
@@ -289,8 +341,8 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::operator=(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::operator=(
 		static_binary_tree &&other
 	) & -> static_binary_tree &
 	{
@@ -299,18 +351,20 @@ namespace asm_lsw
 			m_helper = std::move(other.m_helper);
 			m_used_indices = std::move(other.m_used_indices);
 			m_used_indices_r1_support = std::move(other.m_used_indices_r1_support);
+			m_size = std::move(other.m_size);
 			m_leftmost_idx = std::move(other.m_leftmost_idx);
 			m_past_end_idx = std::move(other.m_past_end_idx);
-				
+			m_height = std::move(other.m_height);
+			
 			m_used_indices_r1_support.set_vector(&this->m_used_indices);
 		}
 		return *this;
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <typename t_collection>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::move_to_vector(
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::move_to_vector(
 		t_collection &collection
 	) -> std::vector <value_type>
 	{
@@ -324,13 +378,13 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	void static_binary_tree <t_key, t_mapped, t_enable_serialize>::fill_used_indices(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	void static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::fill_used_indices(
 		size_type const target, size_type const lb, size_type const rb
 	)
 	{
 		size_type const mid(lb + (rb - lb) / 2);
-		m_used_indices[target] = 1;
+		m_used_indices[slot(target)] = 1;
 		
 		if (lb < mid)
 			fill_used_indices(left_child(target), lb, mid - 1);
@@ -340,14 +394,14 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <typename t_vector>
-	void static_binary_tree <t_key, t_mapped, t_enable_serialize>::fill_tree(
+	void static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::fill_tree(
 		t_vector const &input_vec, size_type const target, size_type const lb, size_type const rb
 	)
 	{
 		size_type const mid(lb + (rb - lb) / 2);
-		size_type pos(m_used_indices_r1_support.rank(target));
+		size_type pos(key_index(target));
 		m_helper.value(pos) = std::move(input_vec[mid]);
 		
 		if (lb < mid)
@@ -358,7 +412,7 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <
 		typename t_vector,
 		typename std::enable_if <
@@ -366,27 +420,45 @@ namespace asm_lsw
 			util::is_sequence_container <t_vector>::value
 		>::type *
 	>
-	static_binary_tree <t_key, t_mapped, t_enable_serialize>::static_binary_tree(
+	static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::static_binary_tree(
 		t_vector &input_vec
 	)
 	{
 		auto const size(input_vec.size());
 		if (size)
 		{
+			m_size = size;
+			if (size <= s_linear_search_limit)
 			{
 				helper_type h(size);
 				m_helper = std::move(h);
+				
+				m_helper.sort(input_vec);
+				for (size_type i(0); i < size; ++i)
+					m_helper.value(i) = std::move(input_vec[i]);
+				
+				m_past_end_idx = size;
+				return;
 			}
 			
 			{
+				// Since the input is split at the median, only the last level of the tree may
+				// have unused slots and so the dense storage takes less than twice the space.
 				size_type complete_size(sdsl::util::upper_power_of_2(1 + size) - 1);
 				sdsl::bit_vector vec(complete_size, 0);
 				m_used_indices = std::move(vec);
+				m_height = sdsl::bits::hi(1 + complete_size);
+				
+				helper_type h(s_dense_storage ? complete_size : size);
+				m_helper = std::move(h);
 			}
 			
 			fill_used_indices(0, 0, size - 1);
-			sdsl::bit_vector::rank_1_type used_indices_r1_support(&m_used_indices);
-			m_used_indices_r1_support = std::move(used_indices_r1_support);
+			if (!s_dense_storage)
+			{
+				sdsl::bit_vector::rank_1_type used_indices_r1_support(&m_used_indices);
+				m_used_indices_r1_support = std::move(used_indices_r1_support);
+			}
 			
 			m_helper.sort(input_vec);
 			fill_tree(input_vec, 0, 0, size - 1);
@@ -406,13 +478,13 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	bool static_binary_tree <t_key, t_mapped, t_enable_serialize>::left_child_c(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	bool static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::left_child_c(
 		size_type &i /* inout */
 	) const
 	{
 		size_type j(left_child(i));
-		if (j < m_used_indices.size() && m_used_indices[j])
+		if (is_used(j))
 		{
 			i = j;
 			return true;
@@ -421,13 +493,13 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	bool static_binary_tree <t_key, t_mapped, t_enable_serialize>::right_child_c(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	bool static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::right_child_c(
 		size_type &i /* inout */
 	) const
 	{
 		size_type j(right_child(i));
-		if (j < m_used_indices.size() && m_used_indices[j])
+		if (is_used(j))
 		{
 			i = j;
 			return true;
@@ -436,8 +508,8 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	bool static_binary_tree <t_key, t_mapped, t_enable_serialize>::parent_c(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	bool static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::parent_c(
 		size_type &i /* inout */
 	) const
 	{
@@ -450,8 +522,8 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	bool static_binary_tree <t_key, t_mapped, t_enable_serialize>::find_leftmost(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	bool static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::find_leftmost(
 		size_type &i /* inout */
 	) const
 	{
@@ -467,98 +539,157 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::find(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::slot(
+		size_type i
+	) const -> size_type
+	{
+		if (static_binary_tree_layout::bfs == t_layout)
+			return i;
+		
+		// Descend to the subtree that contains i. The subtrees are complete, so the BFS index
+		// of a node in the top tree is the same as in the whole tree.
+		size_type retval(0);
+		size_type height(m_height);
+		while (1 < height)
+		{
+			size_type const top_height(static_binary_tree_layout::veb == t_layout ? height / 2 : s_block_height);
+			if (height <= top_height)
+				break;
+			
+			size_type const depth(sdsl::bits::hi(1 + i));
+			if (depth < top_height)
+			{
+				if (static_binary_tree_layout::blocked == t_layout)
+					break;
+				
+				height = top_height;
+				continue;
+			}
+			
+			// Find the bottom tree the node belongs to and the node's index in it.
+			size_type const bottom_height(height - top_height);
+			size_type const rel_depth(depth - top_height);
+			size_type const subtree_root(((1 + i) >> rel_depth) - (size_type(1) << top_height));
+			size_type const top_size((size_type(1) << top_height) - 1);
+			size_type const bottom_size((size_type(1) << bottom_height) - 1);
+			
+			retval += top_size + subtree_root * bottom_size;
+			i = (1 + i) - ((1 + top_size + subtree_root) << rel_depth) + (size_type(1) << rel_depth) - 1;
+			height = bottom_height;
+		}
+		
+		return retval + i;
+	}
+	
+	
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::key_index(
+		size_type const i
+	) const -> size_type
+	{
+		if (is_linear())
+			return i;
+		
+		if (s_dense_storage)
+			return slot(i);
+		
+		return m_used_indices_r1_support.rank(i);
+	}
+	
+	
+	// Descend from the root and remember the last node the key of which was not less than key.
+	// The next node is chosen arithmetically and the grandchildren's keys are prefetched.
+	// Only the last level may have unused nodes and their children are past the end, so with
+	// dense storage the loop runs for the height of the tree and an unused node only needs to
+	// be ignored. Otherwise the keys are located with rank queries and the loop stops at an
+	// unused node.
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::lower_bound_idx(
 		key_type const &key
-	) const -> const_iterator
+	) const -> size_type
 	{
-		if (empty())
-			return cend();
+		if (is_linear())
+			return m_helper.count_less(key);
 		
+		size_type retval(m_past_end_idx);
 		size_type idx(0);
-		while (true)
+		size_type const count(m_used_indices.size());
+		if (s_dense_storage)
 		{
-			size_type key_idx(m_used_indices_r1_support.rank(idx));
-			auto const found_key(m_helper.key(key_idx));
-			if (key < found_key)
-			{
-				if (!left_child_c(idx))
-					return cend();
-			}
-			else if (found_key < key)
+			while (idx < count)
 			{
-				if (!right_child_c(idx))
-					return cend();
+				auto const slot_idx(slot(idx));
+				bool const is_used(m_used_indices[slot_idx]);
+				bool const is_less(m_helper.key(slot_idx) < key);
+				retval = (is_used && !is_less ? idx : retval);
+				idx = left_child(idx) + is_less;
+				
+				auto const next_idx(left_child(idx));
+				if (next_idx < count)
+					util::prefetch(m_helper.key_address(slot(next_idx)));
 			}
-			else
+		}
+		else
+		{
+			while (idx < count && m_used_indices[idx])
 			{
-				return const_iterator(*this, idx);
+				bool const is_less(m_helper.key(m_used_indices_r1_support.rank(idx)) < key);
+				retval = (is_less ? retval : idx);
+				idx = left_child(idx) + is_less;
+				
+				auto const next_idx(left_child(idx));
+				if (next_idx < count)
+					util::prefetch(m_helper.key_address(m_used_indices_r1_support.rank(next_idx)));
 			}
 		}
+		return retval;
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::lower_bound(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::find(
 		key_type const &key
 	) const -> const_iterator
 	{
-		if (empty())
+		auto const idx(lower_bound_idx(key));
+		if (m_past_end_idx == idx || key < m_helper.key(key_index(idx)))
 			return cend();
 		
-		const_iterator retval(cend());
-		lower_bound_subtree(key, 0, retval);
-		return retval;
+		return const_iterator(*this, idx);
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	bool static_binary_tree <t_key, t_mapped, t_enable_serialize>::lower_bound_subtree(
-		key_type const &key, size_type idx, const_iterator &it /* out */
-	) const
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::lower_bound(
+		key_type const &key
+	) const -> const_iterator
 	{
-		if (!m_used_indices[idx])
-			return false;
-		
-		size_type key_idx(m_used_indices_r1_support.rank(idx));
-		auto const found_key(m_helper.key(key_idx));
-		if (found_key < key)
-		{
-			// The found value is less than key. Try to find a greater value.
-			if (right_child_c(idx))
-				return lower_bound_subtree(key, idx, it);
-			
-			return false;
-		}
-		else
-		{
-			auto next_idx(idx);
-			// The found value is not less than key. Continue by trying to find a lesser value.
-			if (! (left_child_c(next_idx) && lower_bound_subtree(key, next_idx, it)))
-				it = const_iterator(*this, idx);
-			return true;
-		}
+		return const_iterator(*this, lower_bound_idx(key));
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::serialize_common(
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::serialize_common(
 		std::ostream &out,
 		sdsl::structure_tree_node *child
 	) const -> size_type
 	{
 		size_type written_bytes(0);
 		written_bytes += m_used_indices.serialize(out, child, "used_indices");
-		written_bytes += m_used_indices_r1_support.serialize(out, child, "used_indices_r1_support");
+		if (s_dense_storage)
+			written_bytes += write_member(m_size, out, child, "size");
+		else
+			written_bytes += m_used_indices_r1_support.serialize(out, child, "used_indices_r1_support");
 		written_bytes += write_member(m_leftmost_idx, out, child, "leftmost_idx");
 		written_bytes += write_member(m_past_end_idx, out, child, "past_end_idx");
 		return written_bytes;
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <typename Fn, bool t_dummy>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::serialize_keys(
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::serialize_keys(
 		std::ostream &out,
 		Fn value_callback,
 		sdsl::structure_tree_node *v,
@@ -576,9 +707,9 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <bool t_dummy>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::serialize(
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::serialize(
 		std::ostream &out, sdsl::structure_tree_node *v, std::string name
 	) const -> typename std::enable_if <t_enable_serialize && t_dummy, size_type>::type
 	{
@@ -593,21 +724,27 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	void static_binary_tree <t_key, t_mapped, t_enable_serialize>::load_common(std::istream &in)
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	void static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::load_common(std::istream &in)
 	{
 		m_used_indices.load(in);
-		m_used_indices_r1_support.load(in);
+		if (s_dense_storage)
+			sdsl::read_member(m_size, in);
+		else
+		{
+			m_used_indices_r1_support.load(in);
+			m_used_indices_r1_support.set_vector(&this->m_used_indices);
+			m_size = m_helper.size();
+		}
 		sdsl::read_member(m_leftmost_idx, in);
 		sdsl::read_member(m_past_end_idx, in);
-		
-		m_used_indices_r1_support.set_vector(&this->m_used_indices);
+		m_height = sdsl::bits::hi(1 + m_used_indices.size());
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <typename Fn, bool t_dummy>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::load_keys(
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::load_keys(
 		std::istream &in,
 		Fn value_callback
 	) -> typename std::enable_if <is_map_type && t_dummy>::type
@@ -617,9 +754,9 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
 	template <bool t_dummy>
-	auto static_binary_tree <t_key, t_mapped, t_enable_serialize>::load(
+	auto static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::load(
 		std::istream& in
 	) -> typename std::enable_if <t_enable_serialize && t_dummy>::type
 	{
@@ -628,8 +765,8 @@ namespace asm_lsw
 	}
 	
 	
-	template <typename t_key, typename t_mapped, bool t_enable_serialize>
-	void static_binary_tree <t_key, t_mapped, t_enable_serialize>::print() const
+	template <typename t_key, typename t_mapped, bool t_enable_serialize, static_binary_tree_layout t_layout>
+	void static_binary_tree <t_key, t_mapped, t_enable_serialize, t_layout>::print() const
 	{
 		size_type const count(m_used_indices.size());
 		
@@ -653,6 +790,12 @@ namespace asm_lsw { namespace detail {
 	template <typename t_tree, typename t_it_val, typename t_it_ref>
 	void static_binary_tree_iterator_tpl <t_tree, t_it_val, t_it_ref>::increment()
 	{
+		if (m_tree->is_linear())
+		{
+			++m_idx;
+			return;
+		}
+		
 		size_type next_idx(m_idx);
 		if (m_tree->right_child_c(next_idx))
 		{
@@ -683,6 +826,12 @@ namespace asm_lsw { namespace detail {
 	template <typename t_tree, typename t_it_val, typename t_it_ref>
 	void static_binary_tree_iterator_tpl <t_tree, t_it_val, t_it_ref>::decrement()
 	{
+		if (m_tree->is_linear())
+		{
+			--m_idx;
+			return;
+		}
+		
 		size_type prev_idx(m_idx);
 		
 		// If the current node has a left child, it must have been
@@ -727,8 +876,8 @@ namespace asm_lsw { namespace detail {
 	template <typename t_tree, typename t_it_val, typename t_it_ref>
 	auto static_binary_tree_iterator_tpl <t_tree, t_it_val, t_it_ref>::dereference() const -> t_it_ref
 	{
-		assert(m_idx < m_tree->m_used_indices.size());
-		size_type const key_idx(m_tree->m_used_indices_r1_support.rank(m_idx));
+		assert(m_idx < (m_tree->is_linear() ? m_tree->size() : m_tree->m_used_indices.size()));
+		size_type const key_idx(m_tree->key_index(m_idx));
 		return m_tree->m_helper.dereference(key_idx);
 	}
 }}
@@ -18,10 +18,15 @@
 #define ASM_LSW_STATIC_BINARY_TREE_HELPER_HH
 
 #include <asm_lsw/util.hh>
+#include <cstdint>
 #include <sdsl/int_vector.hpp>
 #include <utility>
 #include <vector>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 
 namespace asm_lsw { namespace detail {
 
@@ -40,6 +45,93 @@ namespace asm_lsw { namespace detail {
 	};
 
 
+	// Height of the largest complete subtree whose values fit in a cache line.
+	constexpr std::size_t static_binary_tree_block_height(std::size_t const value_size)
+	{
+		std::size_t retval(1);
+		while ((std::size_t(2) << retval) - 1 <= 64 / value_size)
+			++retval;
+		return retval;
+	}
+	
+	
+	// Count the keys less than key in a sorted int_vector without branching on the keys.
+	template <typename t_key>
+	struct static_binary_tree_count_less
+	{
+		template <typename t_vector>
+		std::size_t operator()(t_vector const &keys, t_key const key) const
+		{
+			std::size_t retval(0);
+			std::size_t const count(keys.size());
+			for (std::size_t i(0); i < count; ++i)
+				retval += (keys[i] < key);
+			return retval;
+		}
+	};
+	
+	
+#ifdef __AVX2__
+	// The int_vector stores the keys packed with their native width, so its words may be loaded
+	// as vectors of keys. AVX2 only has signed comparison, so the sign bits are flipped first.
+	// Only the set helper stores its keys in an int_vector, so only set trees are vectorized.
+	template <>
+	struct static_binary_tree_count_less <uint32_t>
+	{
+		template <typename t_vector>
+		std::size_t operator()(t_vector const &keys, uint32_t const key) const
+		{
+			__m256i const sign(_mm256_set1_epi32(INT32_MIN));
+			__m256i const needle(_mm256_xor_si256(_mm256_set1_epi32(key), sign));
+			auto const *data(reinterpret_cast <__m256i const *>(keys.data()));
+			
+			std::size_t retval(0);
+			std::size_t i(0);
+			std::size_t const count(keys.size());
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256i const vals(_mm256_xor_si256(_mm256_loadu_si256(data++), sign));
+				__m256i const is_less(_mm256_cmpgt_epi32(needle, vals));
+				retval += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(is_less)));
+			}
+			
+			for (; i < count; ++i)
+				retval += (keys[i] < key);
+			
+			return retval;
+		}
+	};
+	
+	
+	template <>
+	struct static_binary_tree_count_less <uint64_t>
+	{
+		template <typename t_vector>
+		std::size_t operator()(t_vector const &keys, uint64_t const key) const
+		{
+			__m256i const sign(_mm256_set1_epi64x(INT64_MIN));
+			__m256i const needle(_mm256_xor_si256(_mm256_set1_epi64x(key), sign));
+			auto const *data(reinterpret_cast <__m256i const *>(keys.data()));
+			
+			std::size_t retval(0);
+			std::size_t i(0);
+			std::size_t const count(keys.size());
+			for (; i + 4 <= count; i += 4)
+			{
+				__m256i const vals(_mm256_xor_si256(_mm256_loadu_si256(data++), sign));
+				__m256i const is_less(_mm256_cmpgt_epi64(needle, vals));
+				retval += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(is_less)));
+			}
+			
+			for (; i < count; ++i)
+				retval += (keys[i] < key);
+			
+			return retval;
+		}
+	};
+#endif
+	
+	
 	template <typename t_key, typename t_mapped, bool t_enable_serialize>
 	class static_binary_tree_helper
 	{
@@ -78,6 +170,17 @@ namespace asm_lsw { namespace detail {
 		size_type const size() const { return m_values.size(); }
 		
 		key_type const &key(size_type idx) const { return m_values[idx].first; }
+		void const *key_address(size_type idx) const { return m_values.data() + idx; }
+		
+		// Number of keys less than key, for trees stored in sorted order. Not vectorized since the
+		// keys are interleaved with the values and the linear search limit allows only a few pairs.
+		size_type count_less(key_type const &key) const
+		{
+			size_type retval(0);
+			for (auto const &kv : m_values)
+				retval += (kv.first < key);
+			return retval;
+		}
 		mapped_type const &mapped(size_type idx) const { return m_values[idx].second; }
 
 		reference value(size_type idx) { return m_values[idx]; }
@@ -190,6 +293,14 @@ namespace asm_lsw { namespace detail {
 		size_type const size() const { return m_keys.size(); }
 		
 		key_type const key(size_type idx) const { return m_keys[idx]; }
+		void const *key_address(size_type idx) const { return m_keys.data() + idx * std::numeric_limits <t_key>::digits / 64; }
+		
+		// Number of keys less than key, for trees stored in sorted order.
+		size_type count_less(key_type const key) const
+		{
+			static_binary_tree_count_less <t_key> count_less_fn;
+			return count_less_fn(m_keys, key);
+		}
 		mapped_type const mapped(size_type idx) const { return key(idx); }
 		const_reference const value(size_type idx) const { return key(idx); }
 		
@@ -227,13 +338,13 @@ namespace asm_lsw { namespace detail {
 			size_type const count(tree.m_used_indices.size());
 
 			std::cerr << "Keys:   ";
-			auto it(m_keys.cbegin());
+			size_type key_idx(0);
 			for (size_type i(0); i < count; ++i)
 			{
 				if (tree.m_used_indices[i])
 				{
-					std::cerr << " " << std::hex << std::setw(2) << std::setfill('0') << +(*it);
-					++it;
+					std::cerr << " " << std::hex << std::setw(2) << std::setfill('0') << +(m_keys[t_tree::s_dense_storage ? i : key_idx]);
+					++key_idx;
 				}
 				else
 				{
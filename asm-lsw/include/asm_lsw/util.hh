@@ -19,9 +19,15 @@
 #define ASM_LSW_UTIL_HH
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
 #include <limits>
+#include <mutex>
 #include <sdsl/io.hpp>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #define DO_PRAGMA(x) _Pragma (#x)
 #define TODO(x) DO_PRAGMA(message ("TODO - " #x))
@@ -148,6 +154,172 @@ namespace asm_lsw { namespace util {
 	}
 	
 	
+	// Hint that the cache line at addr will be read soon.
+	inline void prefetch(void const *addr)
+	{
+		__builtin_prefetch(addr);
+	}
+	
+	
+	// Call fn(i) for each i in [0, count) using thread_count threads (or hardware_concurrency if zero).
+	// The indices are handed out one at a time, so the calls may take different amounts of time.
+	// The first exception thrown by fn is rethrown after all the threads have finished.
+	template <typename Fn>
+	void parallel_for(std::size_t const count, std::size_t thread_count, Fn &&fn)
+	{
+		if (0 == thread_count)
+			thread_count = std::max(1U, std::thread::hardware_concurrency());
+		thread_count = std::min(thread_count, count);
+		
+		if (thread_count <= 1)
+		{
+			for (std::size_t i(0); i < count; ++i)
+				fn(i);
+			return;
+		}
+		
+		std::atomic <std::size_t> next(0);
+		std::exception_ptr exc;
+		std::mutex exc_mutex;
+		auto const thread_fn([&](){
+			try
+			{
+				std::size_t i(0);
+				while ((i = next++) < count)
+					fn(i);
+			}
+			catch (...)
+			{
+				std::lock_guard <std::mutex> lock(exc_mutex);
+				if (!exc)
+					exc = std::current_exception();
+				next = count;
+			}
+		});
+		
+		std::vector <std::thread> threads;
+		threads.reserve(thread_count - 1);
+		for (std::size_t i(1); i < thread_count; ++i)
+			threads.emplace_back(thread_fn);
+		
+		// Use the calling thread, too.
+		thread_fn();
+		
+		for (auto &thread : threads)
+			thread.join();
+		
+		if (exc)
+			std::rethrow_exception(exc);
+	}
+	
+	
+	// Result of a probe in search_monotone.
+	enum class search_direction : uint8_t
+	{
+		right,
+		found,
+		left,
+		stop
+	};
+	
+	
+	namespace detail {
+		
+		// Narrow [lb, rb] by the result of probing idx. Return true if the search should continue;
+		// found is set if idx was found.
+		template <typename t_size>
+		bool narrow_search_range(search_direction const dir, t_size const idx, t_size &lb, t_size &rb, bool &found)
+		{
+			switch (dir)
+			{
+				case search_direction::found:
+					found = true;
+					return false;
+					
+				case search_direction::right:
+					// Prevent overflow for idx + 1.
+					if (idx == rb)
+						return false;
+					
+					lb = 1 + idx;
+					return true;
+					
+				case search_direction::left:
+					// Prevent overflow for idx - 1.
+					if (idx == lb)
+						return false;
+					
+					rb = idx - 1;
+					return true;
+					
+				case search_direction::stop:
+				default:
+					return false;
+			}
+		}
+	}
+	
+	
+	// Binary search for an index in [lb, rb] for which probe returns search_direction::found.
+	// probe has to be monotone, i.e. return right for the indices before the found ones and left
+	// for the ones after them. stop ends the search unsuccessfully.
+	template <typename t_size, typename t_probe_fn>
+	bool search_monotone(t_size lb, t_size rb, t_size &i, t_probe_fn &&probe)
+	{
+		bool found(false);
+		while (lb <= rb)
+		{
+			auto const mid(lb + (rb - lb) / 2);
+			if (!detail::narrow_search_range(probe(mid), mid, lb, rb, found))
+			{
+				if (found)
+					i = mid;
+				return found;
+			}
+		}
+		
+		return false;
+	}
+	
+	
+	// Like search_monotone but handle two levels of the binary search in each round. prefetch is
+	// called for the middle index and the midpoints of both halves before the middle index is
+	// probed, so that the memory accesses of the second probe overlap with those of the first.
+	// The indices are probed in the same order as with search_monotone.
+	template <typename t_size, typename t_prefetch_fn, typename t_probe_fn>
+	bool search_monotone_batched(t_size lb, t_size rb, t_size &i, t_prefetch_fn &&prefetch, t_probe_fn &&probe)
+	{
+		bool found(false);
+		while (lb <= rb)
+		{
+			auto const mid(lb + (rb - lb) / 2);
+			prefetch(mid);
+			if (lb < mid)
+				prefetch(lb + (mid - 1 - lb) / 2);
+			if (mid < rb)
+				prefetch(mid + 1 + (rb - mid - 1) / 2);
+			
+			if (!detail::narrow_search_range(probe(mid), mid, lb, rb, found))
+			{
+				if (found)
+					i = mid;
+				return found;
+			}
+			
+			// The midpoint of the remaining half has been prefetched.
+			auto const next(lb + (rb - lb) / 2);
+			if (!detail::narrow_search_range(probe(next), next, lb, rb, found))
+			{
+				if (found)
+					i = next;
+				return found;
+			}
+		}
+		
+		return false;
+	}
+	
+	
 	// Choose either write_member or serialize. The latter probably isn't needed much.
 	template <typename t_value, bool t_has_serialize = sdsl::has_serialize <t_value>::value>
 	struct serialize_value_fn {};
@@ -27,7 +27,7 @@ namespace asm_lsw {
 	template <typename t_key, typename t_value = void>
 	class x_fast_trie : public x_fast_trie_base <detail::x_fast_trie_spec <t_key, t_value>>
 	{
-		template <typename, typename, bool> friend class x_fast_trie_compact;
+		template <typename, typename, bool, std::size_t, bool> friend class x_fast_trie_compact;
 		
 	protected:
 		typedef x_fast_trie_base <detail::x_fast_trie_spec <t_key, t_value>> base_class;
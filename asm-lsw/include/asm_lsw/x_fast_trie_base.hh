@@ -40,7 +40,7 @@ namespace asm_lsw {
 		static_assert(std::is_integral <typename t_spec::key_type>::value, "Unsigned integer required.");
 		static_assert(!std::is_signed <typename t_spec::key_type>::value, "Unsigned integer required.");
 		
-		template <typename, typename, bool>
+		template <typename, typename, bool, std::size_t, bool>
 		friend class x_fast_trie_compact;
 		
 		template <typename t_other_spec>
@@ -66,6 +66,7 @@ namespace asm_lsw {
 		typedef typename t_spec::template map_adaptor_trait <key_type, leaf_link_type> leaf_link_map_trait;
 		typedef typename level_map_trait::type level_map;
 		typedef typename t_spec::lss_find_fn lss_find_fn;
+		typedef detail::x_fast_trie_top_level_table <key_type, t_spec::top_levels> top_level_table;
 
 	public:
 		typedef typename leaf_link_map_trait::type leaf_link_map;
@@ -161,6 +162,7 @@ namespace asm_lsw {
 
 	protected:
 		lss_access m_lss;
+		top_level_table m_top_levels;
 		leaf_link_map m_leaf_links;
 		key_type m_min{};
 
@@ -223,6 +225,12 @@ namespace asm_lsw {
 		bool find_lowest_ancestor(key_type const key, typename level_map::const_iterator &it, level_idx_type &level) const;
 		bool find_node(key_type const key, level_idx_type const level, typename level_map::const_iterator &node) const;
 		
+		// Queries for the closed range [lo, hi].
+		bool range_exists(key_type const lo, key_type const hi) const { key_type first(0); return range_exists(lo, hi, first); }
+		bool range_exists(key_type const lo, key_type const hi, key_type &first) const;
+		size_type count(key_type const lo, key_type const hi) const;
+		template <typename Fn> void for_each_in_range(key_type const lo, key_type const hi, Fn &&fn) const;
+		
 		typename trait::key_type const iterator_key(const_leaf_iterator const &it) const { trait t; return t.key(it); };		
 		typename trait::value_type const &iterator_value(const_leaf_iterator const &it) const { trait t; return t.value(it); };
 
@@ -619,7 +627,32 @@ namespace asm_lsw {
 		level_idx_type &level
 	)
 	{
-		return find_lowest_ancestor(trie, key, it, level, 0, s_levels - 1);
+		if (!top_level_table::is_enabled())
+			return find_lowest_ancestor(trie, key, it, level, 0, s_levels - 1);
+		
+		// Use the table to skip the binary search on the topmost levels.
+		level_idx_type const top_start(top_level_table::s_top_start);
+		level_idx_type const top_level(trie.m_top_levels.lowest_level(key));
+		if (top_start < top_level)
+		{
+			// Either the lowest ancestor is on top_level or only the root remains.
+			if (!trie.m_lss.find_node(key, top_level, it))
+			{
+				assert(s_levels - 1 == top_level);
+				return false;
+			}
+			
+			level = top_level;
+			return true;
+		}
+		
+		// The lowest ancestor is on top_start or below.
+		bool const status(trie.m_lss.find_node(key, top_start, it));
+		assert(status);
+		level = top_start;
+		if (0 < top_start)
+			find_lowest_ancestor(trie, key, it, level, 0, top_start - 1);
+		return true;
 	}
 
 
@@ -664,6 +697,66 @@ namespace asm_lsw {
 	}
 
 
+	template <typename t_spec>
+	bool x_fast_trie_base <t_spec>::range_exists(key_type const lo, key_type const hi, key_type &first) const
+	{
+		if (hi < lo)
+			return false;
+		
+		const_leaf_iterator it;
+		if (!find_successor(lo, it, true))
+			return false;
+		
+		key_type const key(it->first);
+		if (hi < key)
+			return false;
+		
+		first = key;
+		return true;
+	}
+	
+	
+	template <typename t_spec>
+	auto x_fast_trie_base <t_spec>::count(key_type const lo, key_type const hi) const -> size_type
+	{
+		size_type retval(0);
+		for_each_in_range(lo, hi, [&retval](key_type const, auto const & ...){ ++retval; });
+		return retval;
+	}
+	
+	
+	// Call fn with each key (and value) in [lo, hi] in increasing order by following the leaf links.
+	template <typename t_spec>
+	template <typename Fn>
+	void x_fast_trie_base <t_spec>::for_each_in_range(key_type const lo, key_type const hi, Fn &&fn) const
+	{
+		if (hi < lo)
+			return;
+		
+		const_leaf_iterator it;
+		if (!find_successor(lo, it, true))
+			return;
+		
+		trait t;
+		while (true)
+		{
+			key_type const key(it->first);
+			if (hi < key)
+				return;
+			
+			t.visit(it, fn);
+			
+			// The maximum is linked to the minimum.
+			key_type const next(it->second.next);
+			if (next <= key)
+				return;
+			
+			it = m_leaf_links.find(next);
+			assert(m_leaf_links.cend() != it);
+		}
+	}
+	
+	
 	template <typename t_spec>
 	void x_fast_trie_base <t_spec>::print() const
 	{
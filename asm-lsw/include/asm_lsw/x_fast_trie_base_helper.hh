@@ -22,6 +22,8 @@
 #include <asm_lsw/map_adaptor_helper.hh>
 #include <asm_lsw/util.hh>
 #include <cassert>
+#include <limits>
+#include <sdsl/int_vector.hpp>
 
 
 namespace asm_lsw { namespace detail {
@@ -31,7 +33,8 @@ namespace asm_lsw { namespace detail {
 		typename t_value,
 		template <typename, typename, bool, typename> class t_map_adaptor_trait,
 		bool t_enable_serialize,
-		typename t_lss_find_fn
+		typename t_lss_find_fn,
+		std::size_t t_top_levels = 0
 	>
 	struct x_fast_trie_base_spec
 	{
@@ -49,7 +52,116 @@ namespace asm_lsw { namespace detail {
 		using map_adaptor_trait = t_map_adaptor_trait <t_map_key, t_map_value, t_default_enable_serialize, t_map_access_key>;
 		
 		typedef t_lss_find_fn lss_find_fn;
+		
+		// Number of levels below the root for which the lowest ancestor
+		// is stored in a directly indexed table. Zero disables the table.
+		enum { top_levels = t_top_levels };
+	};
+	
+	
+	// Stores the lowest level (below the root) that contains an ancestor of the key
+	// for the topmost levels of an immutable trie. The table is indexed with the
+	// t_top_levels most significant bits of the key, which determine the nodes on those levels.
+	template <typename t_key, std::size_t t_top_levels>
+	class x_fast_trie_top_level_table
+	{
+	public:
+		typedef std::size_t size_type;
+		typedef t_key key_type;
+		
+		static_assert(t_top_levels <= 24, "At most 24 levels may be stored in the table.");
+		
+		static std::size_t const s_levels{std::numeric_limits <key_type>::digits};
+		static std::size_t const s_top_levels{t_top_levels < s_levels ? t_top_levels : s_levels - 1};
+		static std::size_t const s_top_start{s_levels - s_top_levels - 1};
+		
+	protected:
+		sdsl::int_vector <8> m_levels;
+		
+	public:
+		static constexpr bool is_enabled() { return true; }
+		
+		// Returns s_levels - 1 if none of the levels in the table contains an ancestor.
+		std::size_t lowest_level(key_type const key) const { return m_levels[key >> (s_levels - s_top_levels)]; }
+		
+		template <typename t_lss>
+		void construct(t_lss const &lss);
+		
+		size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, std::string name = "") const;
+		void load(std::istream &in);
 	};
+	
+	
+	template <typename t_key>
+	class x_fast_trie_top_level_table <t_key, 0>
+	{
+	public:
+		typedef std::size_t size_type;
+		typedef t_key key_type;
+		
+		static std::size_t const s_levels{std::numeric_limits <key_type>::digits};
+		static std::size_t const s_top_levels{0};
+		static std::size_t const s_top_start{s_levels - 1};
+		
+	public:
+		static constexpr bool is_enabled() { return false; }
+		std::size_t lowest_level(key_type const key) const { return s_levels - 1; }
+		
+		template <typename t_lss>
+		void construct(t_lss const &lss) {}
+		
+		// Nothing to serialize.
+		size_type serialize(std::ostream &out, sdsl::structure_tree_node *v = nullptr, std::string name = "") const { return 0; }
+		void load(std::istream &in) {}
+	};
+	
+	
+	template <typename t_key, std::size_t t_top_levels>
+	template <typename t_lss>
+	void x_fast_trie_top_level_table <t_key, t_top_levels>::construct(t_lss const &lss)
+	{
+		size_type const count(size_type(1) << s_top_levels);
+		sdsl::int_vector <8> levels(count, s_levels - 1);
+		
+		for (size_type i(0); i < count; ++i)
+		{
+			// The ancestors of a key form a path from the root, so scan downwards
+			// until a level without a node is found.
+			key_type const key(i << (s_levels - s_top_levels));
+			for (std::size_t j(s_levels - 1); s_top_start < j; --j)
+			{
+				typename t_lss::level_map::const_iterator it;
+				if (!lss.find_node(key, j - 1, it))
+					break;
+				
+				levels[i] = j - 1;
+			}
+		}
+		
+		m_levels = std::move(levels);
+	}
+	
+	
+	template <typename t_key, std::size_t t_top_levels>
+	auto x_fast_trie_top_level_table <t_key, t_top_levels>::serialize(
+		std::ostream &out, sdsl::structure_tree_node *v, std::string name
+	) const -> size_type
+	{
+		auto *child(sdsl::structure_tree::add_child(v, name, sdsl::util::class_name(*this)));
+		size_type written_bytes(0);
+		
+		written_bytes += m_levels.serialize(out, child, "levels");
+		
+		sdsl::structure_tree::add_size(child, written_bytes);
+		return written_bytes;
+	}
+	
+	
+	template <typename t_key, std::size_t t_top_levels>
+	void x_fast_trie_top_level_table <t_key, t_top_levels>::load(std::istream &in)
+	{
+		m_levels.load(in);
+	}
 
 
 	// FIXME: used by the base class.
@@ -269,6 +381,13 @@ namespace asm_lsw { namespace detail {
 		{
 			return it->second.value;
 		}
+		
+		// Call fn with the key and the value.
+		template <typename t_iterator, typename Fn>
+		void visit(t_iterator it, Fn &&fn) const
+		{
+			fn(it->first, it->second.value);
+		}
 
 		enum { is_map_type = 1 };
 	};
@@ -292,6 +411,13 @@ namespace asm_lsw { namespace detail {
 			return it->first;
 		}
 		
+		// Call fn with the key.
+		template <typename t_iterator, typename Fn>
+		void visit(t_iterator it, Fn &&fn) const
+		{
+			fn(it->first);
+		}
+		
 		enum { is_map_type = 0 };
 		
 		static_assert(
@@ -31,14 +31,25 @@ namespace asm_lsw {
 	
 	
 	// Uses perfect hashing instead of the one provided by STL.
-	template <typename t_key, typename t_value = void, bool t_enable_serialize = false>
-	class x_fast_trie_compact : public x_fast_trie_base <detail::x_fast_trie_compact_spec <t_key, t_value, t_enable_serialize>>
+	// If t_top_levels is non-zero, the lowest ancestor on as many levels below the root
+	// is stored in a directly indexed table of 2^t_top_levels bytes, which reduces the
+	// number of hash lookups in find_predecessor and find_successor.
+	// If t_minimal_hash is true, the level maps and the leaf links allocate only one slot
+	// per element (see map_adaptor_mphf_spec) at the cost of a rank query per lookup.
+	template <
+		typename t_key,
+		typename t_value = void,
+		bool t_enable_serialize = false,
+		std::size_t t_top_levels = 0,
+		bool t_minimal_hash = false
+	>
+	class x_fast_trie_compact : public x_fast_trie_base <detail::x_fast_trie_compact_spec <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>>
 	{
-		template <typename, typename, typename, bool>
+		template <typename, typename, typename, bool, std::size_t>
 		friend class x_fast_trie_compact_as_tpl;
 
 	protected:
-		typedef x_fast_trie_base <detail::x_fast_trie_compact_spec <t_key, t_value, t_enable_serialize>> base_class;
+		typedef x_fast_trie_base <detail::x_fast_trie_compact_spec <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>> base_class;
 		
 		typedef typename base_class::level_idx_type level_idx_type;
 		typedef typename base_class::level_map level_map;
@@ -95,8 +106,8 @@ namespace asm_lsw {
 	};
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
-	x_fast_trie_compact <t_key, t_value, t_enable_serialize>::x_fast_trie_compact(x_fast_trie <key_type, value_type> &other):
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, bool t_minimal_hash>
+	x_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>::x_fast_trie_compact(x_fast_trie <key_type, value_type> &other):
 		x_fast_trie_compact()
 	{
 		typedef util::remove_ref_t <decltype(other)> other_adaptor_type;
@@ -159,6 +170,9 @@ namespace asm_lsw {
 			this->m_leaf_links = std::move(adaptor);
 		}
 		
+		// Top level table.
+		this->m_top_levels.construct(this->m_lss);
+		
 		// Min. value
 		this->m_min = other.m_min;
 		
@@ -167,9 +181,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, bool t_minimal_hash>
 	template <typename Fn, bool t_dummy>
-	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize>::serialize_keys(
+	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>::serialize_keys(
 		std::ostream &out,
 		Fn value_callback,
 		sdsl::structure_tree_node *v,
@@ -190,6 +204,7 @@ namespace asm_lsw {
 		
 		written_bytes += sdsl::write_member(this->m_min, out, child, "min");
 		written_bytes += this->m_lss.serialize(out, child, "lss");
+		written_bytes += this->m_top_levels.serialize(out, child, "top_levels");
 		written_bytes += this->m_leaf_links.serialize_keys(out, serialize_leaf_link, child, "leaf_links");
 		
 		sdsl::structure_tree::add_size(child, written_bytes);
@@ -197,9 +212,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, bool t_minimal_hash>
 	template <bool t_dummy>
-	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize>::serialize(
+	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>::serialize(
 		std::ostream &out,
 		sdsl::structure_tree_node *v,
 		std::string name
@@ -210,6 +225,7 @@ namespace asm_lsw {
 		
 		written_bytes += sdsl::write_member(this->m_min, out, child, "min");
 		written_bytes += this->m_lss.serialize(out, child, "lss");
+		written_bytes += this->m_top_levels.serialize(out, child, "top_levels");
 		written_bytes += this->m_leaf_links.serialize(out, child, "leaf_links");
 		
 		sdsl::structure_tree::add_size(child, written_bytes);
@@ -217,9 +233,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, bool t_minimal_hash>
 	template <typename Fn, bool t_dummy>
-	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize>::load_keys(
+	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>::load_keys(
 		std::istream &in,
 		Fn value_callback
 	) -> typename std::enable_if <trait::is_map_type && t_dummy>::type
@@ -234,18 +250,20 @@ namespace asm_lsw {
 		
 		sdsl::read_member(this->m_min, in);
 		this->m_lss.load(in);
+		this->m_top_levels.load(in);
 		this->m_leaf_links.load_keys(in, load_leaf_link);
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, bool t_minimal_hash>
 	template <bool t_dummy>
-	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize>::load(
+	auto x_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_minimal_hash>::load(
 		std::istream &in
 	) -> typename std::enable_if <t_enable_serialize && t_dummy>::type
 	{
 		sdsl::read_member(this->m_min, in);
 		this->m_lss.load(in);
+		this->m_top_levels.load(in);
 		this->m_leaf_links.load(in);
 	}
 }
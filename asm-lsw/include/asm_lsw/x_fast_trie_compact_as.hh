@@ -93,7 +93,8 @@ namespace asm_lsw {
 	};
 	
 	
-	template <typename t_max_key, typename t_value = void, bool t_enable_serialize = false>
+	// t_top_levels is passed to the tries of all key widths, see x_fast_trie_compact.
+	template <typename t_max_key, typename t_value = void, bool t_enable_serialize = false, std::size_t t_top_levels = 0>
 	class x_fast_trie_compact_as
 	{
 		template <typename, typename>
@@ -124,6 +125,7 @@ namespace asm_lsw {
 			
 		typedef typename as_trait::serialize_value_callback_type serialize_value_callback_type;
 		typedef typename as_trait::load_value_callback_type load_value_callback_type;
+		typedef typename detail::fast_trie_compact_as_range_trait <key_type, value_type>::range_callback_type range_callback_type;
 
 		typedef x_fast_trie_compact_as_leaf_link_iterator_tpl <
 			x_fast_trie_compact_as,
@@ -205,6 +207,10 @@ namespace asm_lsw {
 	
 		virtual void load_(std::istream &in) = 0;
 		
+		virtual bool first_in_range_(key_type const lo, key_type const hi, key_type &first) const = 0;
+		virtual size_type count_(key_type const lo, key_type const hi) const = 0;
+		virtual void for_each_in_range_(key_type const lo, key_type const hi, range_callback_type const &cb) const = 0;
+		
 		static x_fast_trie_compact_as *construct_from_size(std::size_t const key_size);
 		
 	public:
@@ -241,6 +247,14 @@ namespace asm_lsw {
 		typename trait::key_type const iterator_key(const_leaf_iterator const &it) const { trait t; return t.key(it); }
 		typename trait::value_type const &iterator_value(const_leaf_iterator const &it) const { trait t; return t.value(it); }
 		
+		// Queries for the closed range [lo, hi] that do not construct iterators.
+		bool range_exists(key_type const lo, key_type const hi) const { key_type first(0); return first_in_range_(lo, hi, first); }
+		bool range_exists(key_type const lo, key_type const hi, key_type &first) const { return first_in_range_(lo, hi, first); }
+		size_type count(key_type const lo, key_type const hi) const { return count_(lo, hi); }
+		
+		template <typename Fn>
+		void for_each_in_range(key_type const lo, key_type const hi, Fn &&fn) const { range_callback_type cb(std::forward <Fn>(fn)); for_each_in_range_(lo, hi, cb); }
+		
 		template <bool t_dummy = true>
 		auto serialize_keys(
 			std::ostream &out,
@@ -283,8 +297,8 @@ namespace asm_lsw {
 	};
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize = false>
-	class x_fast_trie_compact_as_tpl final : public x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize = false, std::size_t t_top_levels = 0>
+	class x_fast_trie_compact_as_tpl final : public x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>
 	{
 		template <typename>
 		friend struct detail::fast_trie_compact_as_tpl_value_trait;
@@ -292,12 +306,12 @@ namespace asm_lsw {
 		template <bool>
 		friend struct detail::fast_trie_compact_as_tpl_serialize_trait;
 		
-		template <typename, typename, bool>
+		template <typename, typename, bool, std::size_t>
 		friend class x_fast_trie_compact_as;
 		
 	protected:
-		typedef x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize> base_class;
-		typedef x_fast_trie_compact <t_key, t_value, t_enable_serialize> trie_type;
+		typedef x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels> base_class;
+		typedef x_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels> trie_type;
 
 		typedef typename base_class::leaf_it_val leaf_it_val;
 
@@ -308,6 +322,7 @@ namespace asm_lsw {
 		typedef typename base_class::mapped_type mapped_type;
 		typedef typename base_class::serialize_value_callback_type serialize_value_callback_type;
 		typedef typename base_class::load_value_callback_type load_value_callback_type;
+		typedef typename base_class::range_callback_type range_callback_type;
 		typedef typename base_class::const_leaf_iterator const_leaf_iterator;
 
 		typedef detail::x_fast_trie_tag x_fast_trie_tag;
@@ -361,6 +376,10 @@ namespace asm_lsw {
 	
 		virtual void load_(std::istream &in) override;
 		
+		virtual bool first_in_range_(key_type const lo, key_type const hi, key_type &first) const override;
+		virtual size_type count_(key_type const lo, key_type const hi) const override;
+		virtual void for_each_in_range_(key_type const lo, key_type const hi, range_callback_type const &cb) const override;
+		
 		virtual leaf_it_val leaf_link(size_type idx) const override;
 		bool check_find_result(bool const, typename trie_type::const_leaf_iterator const &, const_leaf_iterator &) const;
 	};
@@ -395,24 +414,24 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct_from_size(
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct_from_size(
 		std::size_t const key_size
 	) -> x_fast_trie_compact_as *
 	{
 		switch (key_size)
 		{
 			case 1:
-				return new x_fast_trie_compact_as_tpl <t_max_key, uint8_t, t_value, t_enable_serialize>();
+				return new x_fast_trie_compact_as_tpl <t_max_key, uint8_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			case 2:
-				return new x_fast_trie_compact_as_tpl <t_max_key, uint16_t, t_value, t_enable_serialize>();
+				return new x_fast_trie_compact_as_tpl <t_max_key, uint16_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			case 4:
-				return new x_fast_trie_compact_as_tpl <t_max_key, uint32_t, t_value, t_enable_serialize>();
+				return new x_fast_trie_compact_as_tpl <t_max_key, uint32_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			case 8:
-				return new x_fast_trie_compact_as_tpl <t_max_key, uint64_t, t_value, t_enable_serialize>();
+				return new x_fast_trie_compact_as_tpl <t_max_key, uint64_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			default:
 				assert(0); // Not implemented.
@@ -421,9 +440,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::serialize_keys(
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::serialize_keys(
 		std::ostream &out,
 		serialize_value_callback_type value_callback,
 		sdsl::structure_tree_node *v,
@@ -442,9 +461,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::serialize(
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::serialize(
 		std::ostream &out,
 		sdsl::structure_tree_node *v,
 		std::string name
@@ -462,9 +481,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::load_keys(
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::load_keys(
 		std::istream &in,
 		load_value_callback_type value_callback
 	) -> typename std::enable_if <
@@ -481,9 +500,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::load(
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::load(
 		std::istream &in
 	) -> typename std::enable_if <
 		t_enable_serialize && t_dummy,
@@ -499,8 +518,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::check_find_result(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::check_find_result(
 		bool const res,
 		typename trie_type::const_leaf_iterator const &it,
 		const_leaf_iterator &out_it
@@ -516,8 +535,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find(
 		key_type const key, const_leaf_iterator &out_it
 	) const
 	{
@@ -531,8 +550,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_predecessor(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_predecessor(
 		key_type const key, const_leaf_iterator &out_it, bool allow_equal
 	) const
 	{
@@ -546,8 +565,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_successor(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_successor(
 		key_type const key, const_leaf_iterator &out_it, bool allow_equal
 	) const
 	{
@@ -561,8 +580,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::leaf_link(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::leaf_link(
 		size_type const idx
 	) const -> leaf_it_val
 	{
@@ -575,8 +594,54 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::serialize_keys_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::first_in_range_(
+		key_type const lo, key_type const hi, key_type &first
+	) const
+	{
+		typename trie_type::key_type trie_lo(0), trie_hi(0), trie_first(0);
+		if (!detail::fast_trie_compact_as_adapt_range(this->m_offset, lo, hi, trie_lo, trie_hi))
+			return false;
+		
+		if (!m_trie.range_exists(trie_lo, trie_hi, trie_first))
+			return false;
+		
+		first = this->m_offset + trie_first;
+		return true;
+	}
+	
+	
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::count_(
+		key_type const lo, key_type const hi
+	) const -> size_type
+	{
+		typename trie_type::key_type trie_lo(0), trie_hi(0);
+		if (!detail::fast_trie_compact_as_adapt_range(this->m_offset, lo, hi, trie_lo, trie_hi))
+			return 0;
+		
+		return m_trie.count(trie_lo, trie_hi);
+	}
+	
+	
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	void x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::for_each_in_range_(
+		key_type const lo, key_type const hi, range_callback_type const &cb
+	) const
+	{
+		typename trie_type::key_type trie_lo(0), trie_hi(0);
+		if (!detail::fast_trie_compact_as_adapt_range(this->m_offset, lo, hi, trie_lo, trie_hi))
+			return;
+		
+		key_type const offset(this->m_offset);
+		m_trie.for_each_in_range(trie_lo, trie_hi, [&cb, offset](typename trie_type::key_type const key, auto const & ... args){
+			cb(offset + key, args...);
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::serialize_keys_(
 		std::ostream &out,
 		serialize_value_callback_type value_callback,
 		sdsl::structure_tree_node *v,
@@ -588,8 +653,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::serialize_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::serialize_(
 		std::ostream &out,
 		sdsl::structure_tree_node *v,
 		std::string name
@@ -600,8 +665,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	void x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::load_keys_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	void x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::load_keys_(
 		std::istream &in,
 		load_value_callback_type value_callback
 	)
@@ -611,8 +676,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	void x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::load_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	void x_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::load_(
 		std::istream &in
 	)
 	{
@@ -621,9 +686,9 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <typename t_ret_key, typename t_key>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct_specific(
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct_specific(
 		x_fast_trie <t_key, t_value> &trie,
 		key_type const offset
 	) -> x_fast_trie_compact_as *
@@ -631,14 +696,14 @@ namespace asm_lsw {
 		x_fast_trie <t_ret_key, t_value> temp_trie;
 		fill_trie <decltype(temp_trie), decltype(trie)> ft;
 		ft(temp_trie, trie, offset);
-		x_fast_trie_compact <t_ret_key, t_value, t_enable_serialize> ct(temp_trie);
-		return new x_fast_trie_compact_as_tpl <t_max_key, t_ret_key, t_value, t_enable_serialize>(ct, offset);
+		x_fast_trie_compact <t_ret_key, t_value, t_enable_serialize, t_top_levels> ct(temp_trie);
+		return new x_fast_trie_compact_as_tpl <t_max_key, t_ret_key, t_value, t_enable_serialize, t_top_levels>(ct, offset);
 	}
 
 
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <typename t_key>
-	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct(
+	auto x_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct(
 		x_fast_trie <t_key, t_value> &trie
 	) -> x_fast_trie_compact_as *
 	{
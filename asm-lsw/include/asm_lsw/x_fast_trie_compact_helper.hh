@@ -45,22 +45,36 @@ namespace asm_lsw { namespace detail {
 		typename t_key,
 		typename t_value,
 		bool t_enable_serialize = false,
-		typename t_access_key = map_adaptor_access_key <t_key>
+		typename t_access_key = map_adaptor_access_key <t_key>,
+		bool t_minimal_hash = false
 	>
 	struct x_fast_trie_compact_map_adaptor_trait
 	{
-		using type = fast_trie_compact_map_adaptor <t_key, t_value, t_enable_serialize, t_access_key>;
+		using type = fast_trie_compact_map_adaptor <t_key, t_value, t_enable_serialize, t_access_key, t_minimal_hash>;
 		static constexpr bool needs_custom_constructor() { return false; }
 	};
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	// Fix t_minimal_hash in order to pass the trait to x_fast_trie_base_spec.
+	template <bool t_minimal_hash>
+	struct x_fast_trie_compact_map_adaptor_trait_tpl
+	{
+		template <typename t_key, typename t_value, bool t_enable_serialize, typename t_access_key>
+		using type = x_fast_trie_compact_map_adaptor_trait <t_key, t_value, t_enable_serialize, t_access_key, t_minimal_hash>;
+	};
+	
+	
+	// If t_top_levels is non-zero, the lowest ancestor on the topmost levels
+	// is looked up from a directly indexed table instead of the level maps.
+	// If t_minimal_hash is true, the level maps and the leaf links use minimal perfect hashing.
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels = 0, bool t_minimal_hash = false>
 	using x_fast_trie_compact_spec = x_fast_trie_base_spec <
 		t_key,
 		t_value,
-		x_fast_trie_compact_map_adaptor_trait,
+		x_fast_trie_compact_map_adaptor_trait_tpl <t_minimal_hash>::template type,
 		t_enable_serialize,
-		x_fast_trie_compact_lss_find_fn
+		x_fast_trie_compact_lss_find_fn,
+		t_top_levels
 	>;
 }}
 
@@ -36,8 +36,8 @@ namespace asm_lsw {
 		static_assert(std::is_integral <typename t_spec::key_type>::value, "Unsigned integer required.");
 		static_assert(!std::is_signed <typename t_spec::key_type>::value, "Unsigned integer required.");
 		
-		template <typename, typename, bool> friend class y_fast_trie_compact;
-		template <typename, typename, typename, bool> friend class y_fast_trie_compact_as_tpl;
+		template <typename, typename, bool, std::size_t, static_binary_tree_layout> friend class y_fast_trie_compact;
+		template <typename, typename, typename, bool, std::size_t> friend class y_fast_trie_compact_as_tpl;
 
 	public:
 		typedef typename t_spec::key_type key_type;
@@ -113,6 +113,12 @@ namespace asm_lsw {
 		bool find_subtree_max(key_type const key, const_subtree_iterator &iterator) const;
 		bool find_subtree_exact(key_type const key, const_subtree_map_iterator &iterator) const;
 		void print() const;
+		
+		// Queries for the closed range [lo, hi].
+		bool range_exists(key_type const lo, key_type const hi) const { key_type first(0); return range_exists(lo, hi, first); }
+		bool range_exists(key_type const lo, key_type const hi, key_type &first) const;
+		size_type count(key_type const lo, key_type const hi) const;
+		template <typename Fn> void for_each_in_range(key_type const lo, key_type const hi, Fn &&fn) const;
 
 		y_fast_trie_subtree_map_proxy <subtree_map> subtree_map_proxy() { return y_fast_trie_subtree_map_proxy <subtree_map>(&m_subtrees); }
 		y_fast_trie_subtree_map_proxy <subtree_map const> const subtree_map_proxy() const { return y_fast_trie_subtree_map_proxy <subtree_map const>(&m_subtrees); }
@@ -365,6 +371,68 @@ namespace asm_lsw {
 	}
 	
 	
+	template <typename t_spec>
+	bool y_fast_trie_base <t_spec>::range_exists(key_type const lo, key_type const hi, key_type &first) const
+	{
+		if (hi < lo)
+			return false;
+		
+		const_subtree_iterator it;
+		if (!find_successor(lo, it, true))
+			return false;
+		
+		key_type const key(iterator_key(it));
+		if (hi < key)
+			return false;
+		
+		first = key;
+		return true;
+	}
+	
+	
+	template <typename t_spec>
+	auto y_fast_trie_base <t_spec>::count(key_type const lo, key_type const hi) const -> size_type
+	{
+		size_type retval(0);
+		for_each_in_range(lo, hi, [&retval](key_type const, auto const & ...){ ++retval; });
+		return retval;
+	}
+	
+	
+	// Call fn with each key (and value) in [lo, hi] in increasing order.
+	// Only the first subtree needs to be located with the representative trie.
+	template <typename t_spec>
+	template <typename Fn>
+	void y_fast_trie_base <t_spec>::for_each_in_range(key_type const lo, key_type const hi, Fn &&fn) const
+	{
+		if (hi < lo || 0 == size())
+			return;
+		
+		// If lo is less than every representative, start from the first subtree.
+		key_type st_key(m_reps.min_key());
+		{
+			typename representative_trie_type::const_leaf_iterator leaf_it;
+			if (m_reps.find_predecessor(lo, leaf_it, true))
+				st_key = leaf_it->first;
+		}
+		
+		trait t;
+		do
+		{
+			auto const st_it(m_subtrees.find(st_key));
+			assert(m_subtrees.cend() != st_it);
+			auto const &subtree(st_it->second);
+			for (auto it(subtree.lower_bound(lo)), end(subtree.cend()); it != end; ++it)
+			{
+				if (hi < t.key(it))
+					return;
+				
+				t.visit(it, fn);
+			}
+		} while (find_next_subtree_key(st_key));
+	}
+	
+	
 	template <typename t_spec>
 	void y_fast_trie_base <t_spec>::print() const
 	{
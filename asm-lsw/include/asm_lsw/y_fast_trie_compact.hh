@@ -29,7 +29,7 @@ namespace asm_lsw {
 	template <typename t_spec>
 	class map_adaptor_phf;
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, bool t_minimal_hash>
 	class x_fast_trie_compact;
 	
 	template <typename t_key, typename t_value>
@@ -48,13 +48,19 @@ namespace asm_lsw { namespace detail {
 	};
 	
 
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <
+		typename t_key,
+		typename t_value,
+		bool t_enable_serialize,
+		std::size_t t_top_levels,
+		static_binary_tree_layout t_subtree_layout
+	>
 	using y_fast_trie_compact_spec = y_fast_trie_base_spec <
 		t_key,
 		t_value,
 		y_fast_trie_compact_map_adaptor_trait <t_enable_serialize>::template map_type,
-		x_fast_trie_compact <t_key, void, t_enable_serialize>,
-		typename y_fast_trie_compact_subtree_trait <t_key, t_value, t_enable_serialize>::subtree_type
+		x_fast_trie_compact <t_key, void, t_enable_serialize, t_top_levels, false>,
+		typename y_fast_trie_compact_subtree_trait <t_key, t_value, t_enable_serialize, t_subtree_layout>::subtree_type
 	>;
 }}
 
@@ -62,11 +68,23 @@ namespace asm_lsw { namespace detail {
 namespace asm_lsw {
 
 	// Use perfect hashing instead of the one provided by STL.
-	template <typename t_key, typename t_value = void, bool t_enable_serialize = false>
-	class y_fast_trie_compact : public y_fast_trie_base <detail::y_fast_trie_compact_spec <t_key, t_value, t_enable_serialize>>
+	// t_top_levels is passed to the representative trie, see x_fast_trie_compact.
+	// t_subtree_layout determines the placement of the nodes of the subtrees, see static_binary_tree.
+	template <
+		typename t_key,
+		typename t_value = void,
+		bool t_enable_serialize = false,
+		std::size_t t_top_levels = 0,
+		static_binary_tree_layout t_subtree_layout = static_binary_tree_layout::bfs
+	>
+	class y_fast_trie_compact : public y_fast_trie_base <
+		detail::y_fast_trie_compact_spec <t_key, t_value, t_enable_serialize, t_top_levels, t_subtree_layout>
+	>
 	{
 	public:
-		typedef y_fast_trie_base <detail::y_fast_trie_compact_spec <t_key, t_value, t_enable_serialize>> base_class;
+		typedef y_fast_trie_base <
+			detail::y_fast_trie_compact_spec <t_key, t_value, t_enable_serialize, t_top_levels, t_subtree_layout>
+		> base_class;
 		typedef typename base_class::key_type				key_type;
 		typedef typename base_class::value_type				value_type;
 		typedef typename base_class::size_type				size_type;
@@ -124,9 +142,9 @@ namespace asm_lsw {
 	};
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, static_binary_tree_layout t_subtree_layout>
 	template <typename Fn, bool t_dummy>
-	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize>::serialize_keys(
+	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_subtree_layout>::serialize_keys(
 		std::ostream &out,
 		Fn serialize_value,
 		sdsl::structure_tree_node *v,
@@ -153,9 +171,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, static_binary_tree_layout t_subtree_layout>
 	template <bool t_dummy>
-	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize>::serialize(
+	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_subtree_layout>::serialize(
 		std::ostream &out,
 		sdsl::structure_tree_node *v,
 		std::string name
@@ -173,9 +191,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, static_binary_tree_layout t_subtree_layout>
 	template <typename Fn, bool t_dummy>
-	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize>::load_keys(
+	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_subtree_layout>::load_keys(
 		std::istream &in,
 		Fn load_value
 	) -> typename std::enable_if <trait::is_map_type && t_dummy>::type
@@ -194,9 +212,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_key, typename t_value, bool t_enable_serialize>
+	template <typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels, static_binary_tree_layout t_subtree_layout>
 	template <bool t_dummy>
-	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize>::load(
+	auto y_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels, t_subtree_layout>::load(
 		std::istream &in
 	) -> typename std::enable_if <t_enable_serialize && t_dummy>::type
 	{
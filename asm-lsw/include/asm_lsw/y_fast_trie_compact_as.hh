@@ -134,7 +134,8 @@ namespace asm_lsw {
 	};
 
 	
-	template <typename t_max_key, typename t_value = void, bool t_enable_serialize = false>
+	// t_top_levels is passed to the tries of all key widths, see x_fast_trie_compact.
+	template <typename t_max_key, typename t_value = void, bool t_enable_serialize = false, std::size_t t_top_levels = 0>
 	class y_fast_trie_compact_as
 	{
 	protected:
@@ -163,6 +164,7 @@ namespace asm_lsw {
 		
 	protected:
 		key_type m_offset{0};
+		uint8_t m_key_size{0};
 	
 	protected:
 		template <typename t_dst, typename t_src, typename T = typename t_dst::mapped_type>
@@ -243,11 +245,15 @@ namespace asm_lsw {
 			t_max_key const max
 		);
 
-		y_fast_trie_compact_as(key_type const offset = 0):
-			m_offset(offset)
+		y_fast_trie_compact_as(std::size_t const key_size, key_type const offset = 0):
+			m_offset(offset),
+			m_key_size(key_size)
 		{
 		}
 		
+		template <typename t_trie, typename t_iterator, typename Fn>
+		static void call_with_entry(t_trie const &trie, t_iterator const &it, key_type const offset, Fn &&fn);
+		
 		virtual size_type serialize_keys_(
 			std::ostream &out,
 			serialize_value_callback_type value_callback,
@@ -280,13 +286,32 @@ namespace asm_lsw {
 		static y_fast_trie_compact_as *construct(t_collection &, key_type const min, key_type const max);
 
 		key_type offset() const { return m_offset; }
-
-		virtual size_type key_size() const = 0;
-		virtual size_type size() const = 0;
-
-		virtual bool contains(key_type const key) const = 0;
-		virtual key_type min_key() const = 0;
-		virtual key_type max_key() const = 0;
+		
+		// Call fn with the concrete trie and the offset. The key width is determined
+		// once per call, so the query done in fn may be inlined.
+		template <typename Fn>
+		auto visit(Fn &&fn) const -> decltype(fn(std::declval <y_fast_trie_compact <uint8_t, t_value, t_enable_serialize, t_top_levels> const &>(), key_type(0)));
+		
+		size_type key_size() const { return m_key_size; }
+		size_type size() const;
+		
+		bool contains(key_type const key) const;
+		key_type min_key() const;
+		key_type max_key() const;
+		
+		// Queries that return the key (and the value) instead of an iterator.
+		// fn is called with the key and the value (if any).
+		template <typename Fn> bool visit_predecessor(key_type const key, bool const allow_equal, Fn &&fn) const;
+		template <typename Fn> bool visit_successor(key_type const key, bool const allow_equal, Fn &&fn) const;
+		
+		bool find_predecessor(key_type const key, key_type &pred, bool allow_equal = false) const;
+		bool find_successor(key_type const key, key_type &succ, bool allow_equal = false) const;
+		
+		template <typename T = value_type>
+		bool find_predecessor(key_type const key, key_type &pred, typename std::enable_if <!std::is_void <T>::value, T>::type &val, bool allow_equal = false) const;
+		
+		template <typename T = value_type>
+		bool find_successor(key_type const key, key_type &succ, typename std::enable_if <!std::is_void <T>::value, T>::type &val, bool allow_equal = false) const;
 		
 		virtual bool find(key_type const key, const_subtree_iterator &iterator) const = 0;
 		virtual bool find_predecessor(key_type const key, const_subtree_iterator &iterator, bool allow_equal = false) const = 0;
@@ -300,6 +325,12 @@ namespace asm_lsw {
 		typename trait::key_type const iterator_key(const_subtree_iterator const &it) const { trait t; return t.key(it); }
 		typename trait::value_type const &iterator_value(const_subtree_iterator const &it) const { trait t; return t.value(it); }
 		
+		// Queries for the closed range [lo, hi] that do not construct iterators.
+		bool range_exists(key_type const lo, key_type const hi) const { key_type first(0); return range_exists(lo, hi, first); }
+		bool range_exists(key_type const lo, key_type const hi, key_type &first) const;
+		size_type count(key_type const lo, key_type const hi) const;
+		template <typename Fn> void for_each_in_range(key_type const lo, key_type const hi, Fn &&fn) const;
+		
 		template <bool t_dummy = true>
 		auto serialize_keys(
 			std::ostream &out,
@@ -334,8 +365,8 @@ namespace asm_lsw {
 	};
 	
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize = false>
-	class y_fast_trie_compact_as_tpl final : public y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize = false, std::size_t t_top_levels = 0>
+	class y_fast_trie_compact_as_tpl final : public y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>
 	{
 		template <typename>
 		friend struct detail::fast_trie_compact_as_tpl_value_trait;
@@ -343,12 +374,12 @@ namespace asm_lsw {
 		template <bool>
 		friend struct detail::fast_trie_compact_as_tpl_serialize_trait;
 		
-		template <typename, typename, bool>
+		template <typename, typename, bool, std::size_t>
 		friend class y_fast_trie_compact_as;
 		
 	protected:
-		typedef y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize> base_class;
-		typedef y_fast_trie_compact <t_key, t_value, t_enable_serialize> trie_type;
+		typedef y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels> base_class;
+		typedef y_fast_trie_compact <t_key, t_value, t_enable_serialize, t_top_levels> trie_type;
 		
 		typedef detail::y_fast_trie_base_subtree_iterator_wrapper <
 			typename y_fast_trie_compact_as_subtree_it_val <t_max_key, t_value>::type const
@@ -367,21 +398,17 @@ namespace asm_lsw {
 		trie_type m_trie;
 		
 	protected:
-		y_fast_trie_compact_as_tpl() = default;
+		y_fast_trie_compact_as_tpl(): base_class(sizeof(t_key)) {}
 		
 	public:
 		y_fast_trie_compact_as_tpl(trie_type &trie, t_max_key offset):
-			base_class(offset),
+			base_class(sizeof(t_key), offset),
 			m_trie(std::move(trie))
 		{
 		}
 		
-		virtual size_type key_size() const override					{ return sizeof(t_key); }
-		virtual size_type size() const override						{ return m_trie.size(); }
-		
-		virtual bool contains(key_type const key) const override	{ return m_trie.contains(key - this->m_offset); }
-		virtual key_type min_key() const override					{ return this->m_offset + m_trie.min_key(); }
-		virtual key_type max_key() const override					{ return this->m_offset + m_trie.max_key(); }
+		using base_class::find_predecessor;
+		using base_class::find_successor;
 
 		virtual void print() const override							{ std::cout << "Offset: " << this->m_offset << std::endl; m_trie.print(); }
 
@@ -417,24 +444,24 @@ namespace asm_lsw {
 	};
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
-	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct_from_size(
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct_from_size(
 		std::size_t const key_size
 	) -> y_fast_trie_compact_as *
 	{
 		switch (key_size)
 		{
 			case 1:
-				return new y_fast_trie_compact_as_tpl <t_max_key, uint8_t, t_value, t_enable_serialize>();
+				return new y_fast_trie_compact_as_tpl <t_max_key, uint8_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			case 2:
-				return new y_fast_trie_compact_as_tpl <t_max_key, uint16_t, t_value, t_enable_serialize>();
+				return new y_fast_trie_compact_as_tpl <t_max_key, uint16_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			case 4:
-				return new y_fast_trie_compact_as_tpl <t_max_key, uint32_t, t_value, t_enable_serialize>();
+				return new y_fast_trie_compact_as_tpl <t_max_key, uint32_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			case 8:
-				return new y_fast_trie_compact_as_tpl <t_max_key, uint64_t, t_value, t_enable_serialize>();
+				return new y_fast_trie_compact_as_tpl <t_max_key, uint64_t, t_value, t_enable_serialize, t_top_levels>();
 				
 			default:
 				assert(0); // Not implemented.
@@ -443,9 +470,253 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename Fn>
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::visit(
+		Fn &&fn
+	) const -> decltype(fn(std::declval <y_fast_trie_compact <uint8_t, t_value, t_enable_serialize, t_top_levels> const &>(), key_type(0)))
+	{
+		switch (m_key_size)
+		{
+			case 1:
+				return fn(static_cast <y_fast_trie_compact_as_tpl <t_max_key, uint8_t, t_value, t_enable_serialize, t_top_levels> const &>(*this).m_trie, m_offset);
+				
+			case 2:
+				return fn(static_cast <y_fast_trie_compact_as_tpl <t_max_key, uint16_t, t_value, t_enable_serialize, t_top_levels> const &>(*this).m_trie, m_offset);
+				
+			case 4:
+				return fn(static_cast <y_fast_trie_compact_as_tpl <t_max_key, uint32_t, t_value, t_enable_serialize, t_top_levels> const &>(*this).m_trie, m_offset);
+				
+			default:
+				assert(8 == m_key_size);
+				return fn(static_cast <y_fast_trie_compact_as_tpl <t_max_key, uint64_t, t_value, t_enable_serialize, t_top_levels> const &>(*this).m_trie, m_offset);
+		}
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename t_trie, typename t_iterator, typename Fn>
+	void y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::call_with_entry(
+		t_trie const &trie,
+		t_iterator const &it,
+		key_type const offset,
+		Fn &&fn
+	)
+	{
+		typedef typename t_trie::key_type trie_key_type;
+		detail::y_fast_trie_trait <trie_key_type, t_value> t;
+		t.visit(it, [offset, &fn](trie_key_type const key, auto const & ... args){
+			fn(key_type(offset + key), args...);
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::size() const -> size_type
+	{
+		return visit([](auto const &trie, key_type const) -> size_type { return trie.size(); });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::contains(key_type const key) const
+	{
+		return visit([key](auto const &trie, key_type const offset) -> bool {
+			typedef typename util::remove_ref_t <decltype(trie)>::key_type trie_key_type;
+			if (key < offset || std::numeric_limits <trie_key_type>::max() < key - offset)
+				return false;
+			
+			return trie.contains(key - offset);
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::min_key() const -> key_type
+	{
+		return visit([](auto const &trie, key_type const offset) -> key_type { return offset + trie.min_key(); });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::max_key() const -> key_type
+	{
+		return visit([](auto const &trie, key_type const offset) -> key_type { return offset + trie.max_key(); });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename Fn>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::visit_predecessor(
+		key_type const key,
+		bool const allow_equal,
+		Fn &&fn
+	) const
+	{
+		return visit([key, allow_equal, &fn](auto const &trie, key_type const offset) -> bool {
+			typedef util::remove_ref_t <decltype(trie)> trie_type;
+			typedef typename trie_type::key_type trie_key_type;
+			
+			if (key < offset || 0 == trie.size())
+				return false;
+			
+			typename trie_type::const_subtree_iterator it;
+			if (std::numeric_limits <trie_key_type>::max() < key - offset)
+			{
+				// Every key is less than the given one.
+				auto const status(trie.find(trie.max_key(), it));
+				assert(status);
+			}
+			else if (!trie.find_predecessor(key - offset, it, allow_equal))
+			{
+				return false;
+			}
+			
+			call_with_entry(trie, it, offset, fn);
+			return true;
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename Fn>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::visit_successor(
+		key_type const key,
+		bool const allow_equal,
+		Fn &&fn
+	) const
+	{
+		return visit([key, allow_equal, &fn](auto const &trie, key_type const offset) -> bool {
+			typedef util::remove_ref_t <decltype(trie)> trie_type;
+			typedef typename trie_type::key_type trie_key_type;
+			
+			if (0 == trie.size())
+				return false;
+			
+			typename trie_type::const_subtree_iterator it;
+			if (key < offset)
+			{
+				// Every key is greater than the given one.
+				auto const status(trie.find(trie.min_key(), it));
+				assert(status);
+			}
+			else if (std::numeric_limits <trie_key_type>::max() < key - offset)
+			{
+				return false;
+			}
+			else if (!trie.find_successor(key - offset, it, allow_equal))
+			{
+				return false;
+			}
+			
+			call_with_entry(trie, it, offset, fn);
+			return true;
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::find_predecessor(
+		key_type const key, key_type &pred, bool allow_equal
+	) const
+	{
+		return visit_predecessor(key, allow_equal, [&pred](key_type const k, auto const & ...){ pred = k; });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::find_successor(
+		key_type const key, key_type &succ, bool allow_equal
+	) const
+	{
+		return visit_successor(key, allow_equal, [&succ](key_type const k, auto const & ...){ succ = k; });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename T>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::find_predecessor(
+		key_type const key,
+		key_type &pred,
+		typename std::enable_if <!std::is_void <T>::value, T>::type &val,
+		bool allow_equal
+	) const
+	{
+		return visit_predecessor(key, allow_equal, [&pred, &val](key_type const k, T const &v){ pred = k; val = v; });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename T>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::find_successor(
+		key_type const key,
+		key_type &succ,
+		typename std::enable_if <!std::is_void <T>::value, T>::type &val,
+		bool allow_equal
+	) const
+	{
+		return visit_successor(key, allow_equal, [&succ, &val](key_type const k, T const &v){ succ = k; val = v; });
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::range_exists(
+		key_type const lo, key_type const hi, key_type &first
+	) const
+	{
+		return visit([lo, hi, &first](auto const &trie, key_type const offset) -> bool {
+			typedef typename util::remove_ref_t <decltype(trie)>::key_type trie_key_type;
+			trie_key_type trie_lo(0), trie_hi(0), trie_first(0);
+			if (!detail::fast_trie_compact_as_adapt_range(offset, lo, hi, trie_lo, trie_hi))
+				return false;
+			
+			if (!trie.range_exists(trie_lo, trie_hi, trie_first))
+				return false;
+			
+			first = offset + trie_first;
+			return true;
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::count(
+		key_type const lo, key_type const hi
+	) const -> size_type
+	{
+		return visit([lo, hi](auto const &trie, key_type const offset) -> size_type {
+			typedef typename util::remove_ref_t <decltype(trie)>::key_type trie_key_type;
+			trie_key_type trie_lo(0), trie_hi(0);
+			if (!detail::fast_trie_compact_as_adapt_range(offset, lo, hi, trie_lo, trie_hi))
+				return 0;
+			
+			return trie.count(trie_lo, trie_hi);
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	template <typename Fn>
+	void y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::for_each_in_range(
+		key_type const lo, key_type const hi, Fn &&fn
+	) const
+	{
+		visit([lo, hi, &fn](auto const &trie, key_type const offset){
+			typedef typename util::remove_ref_t <decltype(trie)>::key_type trie_key_type;
+			trie_key_type trie_lo(0), trie_hi(0);
+			if (!detail::fast_trie_compact_as_adapt_range(offset, lo, hi, trie_lo, trie_hi))
+				return;
+			
+			trie.for_each_in_range(trie_lo, trie_hi, [offset, &fn](trie_key_type const key, auto const & ... args){
+				fn(key_type(offset + key), args...);
+			});
+		});
+	}
+	
+	
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::serialize_keys(
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::serialize_keys(
 		std::ostream &out,
 		serialize_value_callback_type value_callback,
 		sdsl::structure_tree_node *v,
@@ -464,9 +735,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::serialize(
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::serialize(
 		std::ostream &out,
 		sdsl::structure_tree_node *v,
 		std::string name
@@ -484,9 +755,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::load_keys(
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::load_keys(
 		std::istream &in,
 		load_value_callback_type value_callback
 	) -> typename std::enable_if <
@@ -503,9 +774,9 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <bool t_dummy>
-	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::load(
+	auto y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::load(
 		std::istream &in
 	) -> typename std::enable_if <
 		t_enable_serialize && t_dummy,
@@ -521,8 +792,8 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::check_find_result(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::check_find_result(
 		bool const res,
 		typename trie_type::const_subtree_iterator it,
 		const_subtree_iterator &out_it
@@ -538,8 +809,8 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find(
 		key_type const key, const_subtree_iterator &out_it
 	) const
 	{
@@ -553,28 +824,28 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_predecessor(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_predecessor(
 		key_type const key, const_subtree_iterator &out_it, bool allow_equal
 	) const
 	{
 		if (key < this->m_offset)
 			return false;
 		else if (std::numeric_limits <typename trie_type::key_type>::max() < key - this->m_offset)
-			return find(max_key(), out_it);
+			return find(this->max_key(), out_it);
 
 		typename trie_type::const_subtree_iterator pred;
 		return check_find_result(m_trie.find_predecessor(key - this->m_offset, pred, allow_equal), pred, out_it);
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_successor(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_successor(
 		key_type const key, const_subtree_iterator &out_it, bool allow_equal
 	) const
 	{
 		if (key < this->m_offset)
-			return find(min_key(), out_it);
+			return find(this->min_key(), out_it);
 		else if (std::numeric_limits <typename trie_type::key_type>::max() < key - this->m_offset)
 			return false;
 
@@ -583,8 +854,8 @@ namespace asm_lsw {
 	}
 
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_subtree_min(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_subtree_min(
 		key_type const key, const_subtree_iterator &out_it
 	) const
 	{
@@ -596,8 +867,8 @@ namespace asm_lsw {
 	}
 
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_subtree_max(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_subtree_max(
 		key_type const key, const_subtree_iterator &out_it
 	) const
 	{
@@ -609,8 +880,8 @@ namespace asm_lsw {
 	}
 
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::find_next_subtree_key(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	bool y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::find_next_subtree_key(
 		key_type &key /* inout */
 	) const
 	{
@@ -628,8 +899,8 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	auto y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::serialize_keys_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::serialize_keys_(
 		std::ostream &out,
 		serialize_value_callback_type value_callback,
 		sdsl::structure_tree_node *v,
@@ -641,8 +912,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	auto y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::serialize_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	auto y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::serialize_(
 		std::ostream &out,
 		sdsl::structure_tree_node *v,
 		std::string name
@@ -653,8 +924,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	void y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::load_keys_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	void y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::load_keys_(
 		std::istream &in,
 		load_value_callback_type value_callback
 	)
@@ -664,8 +935,8 @@ namespace asm_lsw {
 	}
 
 
-	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize>
-	void y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize>::load_(
+	template <typename t_max_key, typename t_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
+	void y_fast_trie_compact_as_tpl <t_max_key, t_key, t_value, t_enable_serialize, t_top_levels>::load_(
 		std::istream &in
 	)
 	{
@@ -674,10 +945,10 @@ namespace asm_lsw {
 	}
 	
 	
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <typename t_ret_key, typename t_collection, typename t_fill>
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize> *
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct_specific(
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels> *
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct_specific(
 		t_collection &collection,
 		t_fill const &fill,
 		key_type const offset,
@@ -688,16 +959,16 @@ namespace asm_lsw {
 		y_fast_trie <t_ret_key, t_value> temp_trie(limit);
 		
 		fill(temp_trie, collection, offset);
-		y_fast_trie_compact <t_ret_key, t_value, t_enable_serialize> ct(temp_trie);
-		return new y_fast_trie_compact_as_tpl <t_max_key, t_ret_key, t_value, t_enable_serialize>(ct, offset);
+		y_fast_trie_compact <t_ret_key, t_value, t_enable_serialize, t_top_levels> ct(temp_trie);
+		return new y_fast_trie_compact_as_tpl <t_max_key, t_ret_key, t_value, t_enable_serialize, t_top_levels>(ct, offset);
 	}
 
 
 	// FIXME: change the trie type to const or non-const based on t_value (void or non-void).
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <typename t_key>
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize> *
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct(
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels> *
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct(
 		y_fast_trie <t_key, t_value> &trie
 	)
 	{
@@ -712,10 +983,10 @@ namespace asm_lsw {
 
 
 	// FIXME: change the collection type to const or non-const based on t_value (void or non-void).
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <typename t_collection>
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize> *
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct(
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels> *
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct(
 		t_collection &collection,
 		t_max_key const min,
 		t_max_key const max
@@ -739,10 +1010,10 @@ namespace asm_lsw {
 
 
 	// FIXME: change the trie type to const or non-const based on t_value (void or non-void).
-	template <typename t_max_key, typename t_value, bool t_enable_serialize>
+	template <typename t_max_key, typename t_value, bool t_enable_serialize, std::size_t t_top_levels>
 	template <typename t_collection, typename t_fill>
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize> *
-	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize>::construct(
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels> *
+	y_fast_trie_compact_as <t_max_key, t_value, t_enable_serialize, t_top_levels>::construct(
 		t_collection &collection,
 		t_fill const &fill,
 		t_max_key const min,
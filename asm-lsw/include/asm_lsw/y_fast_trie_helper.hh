@@ -97,6 +97,13 @@ namespace asm_lsw { namespace detail {
 		{
 			return it->second;
 		}
+		
+		// Call fn with the key and the value.
+		template <typename t_iterator, typename Fn>
+		void visit(t_iterator const &it, Fn &&fn) const
+		{
+			fn(it->first, it->second);
+		}
 	};
 	
 	
@@ -119,6 +126,13 @@ namespace asm_lsw { namespace detail {
 		{
 			return *it;
 		}
+		
+		// Call fn with the key.
+		template <typename t_iterator, typename Fn>
+		void visit(t_iterator const &it, Fn &&fn) const
+		{
+			fn(*it);
+		}
 	};
 	
 	
@@ -136,10 +150,15 @@ namespace asm_lsw { namespace detail {
 	};
 	
 	
-	template <typename t_key, typename t_val, bool t_enable_serialize>
+	template <
+		typename t_key,
+		typename t_val,
+		bool t_enable_serialize,
+		static_binary_tree_layout t_layout = static_binary_tree_layout::bfs
+	>
 	struct y_fast_trie_compact_subtree_trait
 	{
-		typedef static_binary_tree <t_key, t_val, t_enable_serialize> subtree_type;
+		typedef static_binary_tree <t_key, t_val, t_enable_serialize, t_layout> subtree_type;
 	};
 	
 	
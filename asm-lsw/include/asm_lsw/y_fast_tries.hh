@@ -18,6 +18,7 @@
 #ifndef ASM_LSW_Y_FAST_TRIES_HH
 #define ASM_LSW_Y_FAST_TRIES_HH
 
+#include <asm_lsw/concurrent_y_fast_trie.hh>
 #include <asm_lsw/y_fast_trie.hh>
 #include <asm_lsw/y_fast_trie_compact.hh>
 #include <asm_lsw/y_fast_trie_compact_as.hh>
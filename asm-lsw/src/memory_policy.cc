@@ -0,0 +1,189 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+#include <asm_lsw/memory_policy.hh>
+#include <asm_lsw/pool_allocator.hh>
+#include <algorithm>
+#include <fstream>
+#include <sdsl/memory_management.hpp>
+#include <string>
+#include <sys/mman.h>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+
+using namespace asm_lsw;
+
+
+namespace {
+	
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+	// From <numaif.h>, which is not needed otherwise.
+	int const s_mpol_default(0);
+	int const s_mpol_interleave(3);
+	
+	
+	// Parse a node list such as "0-3,6" into a bit mask.
+	bool online_nodes(std::vector <unsigned long> &mask, unsigned long &max_node)
+	{
+		std::ifstream stream("/sys/devices/system/node/online");
+		std::string list;
+		if (! (stream >> list))
+			return false;
+		
+		unsigned long const bits(8 * sizeof(unsigned long));
+		std::size_t pos(0);
+		max_node = 0;
+		while (pos < list.size())
+		{
+			auto const end(list.find(',', pos));
+			auto const range(list.substr(pos, std::string::npos == end ? std::string::npos : end - pos));
+			auto const dash(range.find('-'));
+			unsigned long const first(std::stoul(range.substr(0, dash)));
+			unsigned long const last(std::string::npos == dash ? first : std::stoul(range.substr(1 + dash)));
+			
+			for (unsigned long node(first); node <= last; ++node)
+			{
+				if (mask.size() <= node / bits)
+					mask.resize(1 + node / bits, 0);
+				mask[node / bits] |= (1UL << (node % bits));
+				max_node = std::max(max_node, node);
+			}
+			
+			if (std::string::npos == end)
+				break;
+			pos = 1 + end;
+		}
+		
+		return !mask.empty();
+	}
+	
+	
+	bool set_interleave_policy()
+	{
+		std::vector <unsigned long> mask;
+		unsigned long max_node(0);
+		if (!online_nodes(mask, max_node))
+			return false;
+		
+		// Interleaving does not help with a single node.
+		if (0 == max_node)
+			return false;
+		
+		return 0 == syscall(SYS_set_mempolicy, s_mpol_interleave, mask.data(), 2 + max_node);
+	}
+	
+	
+	void reset_numa_policy()
+	{
+		syscall(SYS_set_mempolicy, s_mpol_default, nullptr, 0);
+	}
+#else
+	bool set_interleave_policy() { return false; }
+	void reset_numa_policy() {}
+#endif
+}
+
+
+memory_policy_scope::memory_policy_scope(huge_page_policy const hp, numa_policy const np):
+	m_huge_page_policy(hp),
+	m_previous_huge_pages(pool_allocator_arena::huge_pages_by_default())
+{
+	switch (hp)
+	{
+		case huge_page_policy::explicit_pages:
+		{
+			// Reserve all the available huge pages for sdsl::int_vector.
+			try
+			{
+				sdsl::memory_manager::use_hugepages();
+			}
+			catch (std::system_error const &)
+			{
+				break;
+			}
+			
+			pool_allocator_arena::set_huge_pages_by_default(true);
+			m_huge_pages_enabled = true;
+			break;
+		}
+		
+		case huge_page_policy::transparent:
+			pool_allocator_arena::set_huge_pages_by_default(true);
+			m_huge_pages_enabled = true;
+			break;
+		
+		case huge_page_policy::none:
+		default:
+			break;
+	}
+	
+	if (numa_policy::interleave == np)
+		m_numa_policy_set = set_interleave_policy();
+}
+
+
+memory_policy_scope::~memory_policy_scope()
+{
+	// sdsl::memory_manager::use_hugepages() cannot be undone, so SDSL keeps using
+	// the reserved huge pages with explicit_pages.
+	pool_allocator_arena::set_huge_pages_by_default(m_previous_huge_pages);
+	
+	// The pages that have already been touched stay where they were placed.
+	if (m_numa_policy_set)
+		reset_numa_policy();
+}
+
+
+bool memory_policy_scope::advise_range(void const *addr, std::size_t const size) const
+{
+	if (! (m_huge_pages_enabled && huge_page_policy::transparent == m_huge_page_policy))
+		return false;
+	
+#ifdef MADV_HUGEPAGE
+	// Only whole huge pages can be backed by them.
+	uintptr_t const start(s_huge_page_size * ((reinterpret_cast <uintptr_t>(addr) + s_huge_page_size - 1) / s_huge_page_size));
+	uintptr_t const end(s_huge_page_size * ((reinterpret_cast <uintptr_t>(addr) + size) / s_huge_page_size));
+	if (end <= start)
+		return false;
+	
+	return 0 == madvise(reinterpret_cast <void *>(start), end - start, MADV_HUGEPAGE);
+#else
+	return false;
+#endif
+}
+
+
+auto detail::address_range_streambuf::overflow(int_type c) -> int_type
+{
+	// Single characters are not part of the vectors.
+	return traits_type::not_eof(c);
+}
+
+
+std::streamsize detail::address_range_streambuf::xsputn(char const *s, std::streamsize n)
+{
+	uintptr_t const start(reinterpret_cast <uintptr_t>(s));
+	if (!m_ranges.empty() && m_ranges.back().second == start)
+		m_ranges.back().second += n;
+	else
+		m_ranges.emplace_back(start, start + n);
+	return n;
+}
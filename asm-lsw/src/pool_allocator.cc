@@ -0,0 +1,202 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/pool_allocator.hh>
+#include <algorithm>
+#include <sys/mman.h>
+
+
+using namespace asm_lsw;
+
+
+std::shared_ptr <pool_allocator_arena> &pool_allocator_arena::current_ptr()
+{
+	// Each thread has its own current arena, so that concurrently constructed
+	// or loaded indices do not take each other's allocations.
+	static thread_local std::shared_ptr <pool_allocator_arena> s_current;
+	return s_current;
+}
+
+
+namespace {
+	std::atomic <bool> s_huge_pages_by_default{false};
+	std::atomic <std::size_t> s_bytes_allocated_without_arena{0};
+}
+
+
+std::shared_ptr <pool_allocator_arena> pool_allocator_arena::current()
+{
+	return current_ptr();
+}
+
+
+bool pool_allocator_arena::huge_pages_by_default()
+{
+	return s_huge_pages_by_default;
+}
+
+
+void pool_allocator_arena::set_huge_pages_by_default(bool huge_pages)
+{
+	s_huge_pages_by_default = huge_pages;
+}
+
+
+std::size_t pool_allocator_arena::bytes_allocated_without_arena()
+{
+	return s_bytes_allocated_without_arena;
+}
+
+
+void pool_allocator_arena::add_bytes_allocated_without_arena(std::size_t const size)
+{
+	s_bytes_allocated_without_arena += size;
+}
+
+
+pool_allocator_arena::pool_allocator_arena(std::size_t block_size):
+	pool_allocator_arena(block_size, huge_pages_by_default())
+{
+}
+
+
+pool_allocator_arena::pool_allocator_arena(std::size_t block_size, bool huge_pages):
+	m_block_size(std::max(block_size, std::size_t(1))),
+	m_huge_pages(huge_pages)
+{
+}
+
+
+auto pool_allocator_arena::add_block(std::size_t size, bool const dedicated) -> block &
+{
+	// Align the blocks to cache lines or to huge pages.
+	std::size_t alignment(64);
+	if (m_huge_pages)
+	{
+		alignment = s_huge_page_size;
+		size = s_huge_page_size * ((size + s_huge_page_size - 1) / s_huge_page_size);
+	}
+	
+	void *ptr(nullptr);
+	if (0 != posix_memalign(&ptr, alignment, size))
+	{
+		std::bad_alloc exc;
+		throw exc;
+	}
+	
+#ifdef MADV_HUGEPAGE
+	// Failure only means that the block is backed by normal pages.
+	if (m_huge_pages)
+		madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+	
+	block blk;
+	blk.ptr.reset(reinterpret_cast <unsigned char *>(ptr));
+	blk.size = size;
+	
+	// Keep the partially used block last, since it is the one used for the next allocations.
+	if (dedicated && !m_blocks.empty())
+		return *m_blocks.emplace(m_blocks.end() - 1, std::move(blk));
+	
+	m_blocks.emplace_back(std::move(blk));
+	return m_blocks.back();
+}
+
+
+unsigned char *pool_allocator_arena::allocate_bytes(std::size_t const size, std::size_t const alignment)
+{
+	std::lock_guard <std::mutex> lock(m_mutex);
+	
+	auto const find_space([size, alignment](block &blk, std::size_t &start) -> bool {
+		uintptr_t const addr(reinterpret_cast <uintptr_t>(blk.ptr.get()) + blk.used);
+		uintptr_t const diff(addr % alignment);
+		start = blk.used + (diff ? alignment - diff : 0);
+		return start + size <= blk.size;
+	});
+	
+	std::size_t start(0);
+	if (m_blocks.empty() || !find_space(m_blocks.back(), start))
+	{
+		// Allocate the large requests separately.
+		auto const dedicated(m_block_size < size + alignment);
+		auto &blk(add_block(dedicated ? size + alignment : m_block_size, dedicated));
+		auto const status(find_space(blk, start));
+		assert(status);
+		blk.used = start + size;
+		m_bytes_used += size;
+		return blk.ptr.get() + start;
+	}
+	
+	auto &blk(m_blocks.back());
+	blk.used = start + size;
+	m_bytes_used += size;
+	return blk.ptr.get() + start;
+}
+
+
+void pool_allocator_arena::deallocate_bytes(unsigned char *ptr, std::size_t const size)
+{
+	std::lock_guard <std::mutex> lock(m_mutex);
+	
+	// Only the most recent allocation from the current block can be returned.
+	if (m_blocks.empty())
+		return;
+	
+	auto &blk(m_blocks.back());
+	auto *start(blk.ptr.get());
+	if (start <= ptr && ptr + size == start + blk.used)
+	{
+		blk.used = ptr - start;
+		m_bytes_used -= size;
+	}
+}
+
+
+std::size_t pool_allocator_arena::block_count()
+{
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_blocks.size();
+}
+
+
+std::size_t pool_allocator_arena::bytes_reserved()
+{
+	std::lock_guard <std::mutex> lock(m_mutex);
+	std::size_t retval(0);
+	for (auto const &blk : m_blocks)
+		retval += blk.size;
+	return retval;
+}
+
+
+std::size_t pool_allocator_arena::bytes_used()
+{
+	std::lock_guard <std::mutex> lock(m_mutex);
+	return m_bytes_used;
+}
+
+
+pool_allocator_arena::scope::scope(std::shared_ptr <pool_allocator_arena> const &arena):
+	m_previous(current_ptr())
+{
+	current_ptr() = arena;
+}
+
+
+pool_allocator_arena::scope::~scope()
+{
+	current_ptr() = std::move(m_previous);
+}
@@ -0,0 +1,47 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <bandit/bandit.h>
+#include <cstdint>
+#include "../aligner/aligner.hh"
+
+using namespace bandit;
+
+
+go_bandit([](){
+	describe("use_semi_external_sa:", [](){
+		it("does not limit the suffix sorting without a budget", [](){
+			AssertThat(use_semi_external_sa(0, 0), Equals(false));
+			AssertThat(use_semi_external_sa(0, SIZE_MAX), Equals(false));
+		});
+		
+		it("sorts in memory if the budget suffices", [](){
+			std::size_t const length(1000);
+			std::size_t const budget(length * in_memory_sa_bytes_per_char);
+			AssertThat(use_semi_external_sa(budget, length), Equals(false));
+			AssertThat(use_semi_external_sa(budget, length - 1), Equals(false));
+			AssertThat(use_semi_external_sa(budget + 1, length), Equals(false));
+		});
+		
+		it("sorts semi-externally if the budget is exceeded", [](){
+			std::size_t const length(1000);
+			std::size_t const budget(length * in_memory_sa_bytes_per_char);
+			AssertThat(use_semi_external_sa(budget - 1, length), Equals(true));
+			AssertThat(use_semi_external_sa(budget, length + 1), Equals(true));
+			AssertThat(use_semi_external_sa(1, 1), Equals(true));
+		});
+	});
+});
@@ -17,6 +17,7 @@
 
 #include <asm_lsw/bp_support_sparse.hh>
 #include <bandit/bandit.h>
+#include <sdsl/sd_vector.hpp>
 
 using namespace bandit;
 
@@ -85,5 +86,65 @@ go_bandit([](){
 			AssertThat(bps.select(2), Equals(5));
 			AssertThat(bps.select(3), Equals(6));
 		});
+
+		it("finds enclosing parentheses", [&](){
+			AssertThat(bps.enclose(6),	Equals(5));
+			AssertThat(bps.enclose(10),	Equals(5));
+			AssertThat(bps.enclose(2),	Equals(bps.size()));
+			AssertThat(bps.enclose(5),	Equals(bps.size()));
+
+			AssertThrows(asm_lsw::invalid_argument, bps.enclose(8));
+			AssertThat(LastException <asm_lsw::invalid_argument>().error <decltype(bps)::error>(), Equals(decltype(bps)::error::bad_parenthesis));
+		});
+	});
+	
+	describe("bp_support_sparse <bp_support_g <>, sd_vector <>>:", [](){
+
+		asm_lsw::bp_support_sparse <sdsl::bp_support_g <>, sdsl::sd_vector <>> bps;
+		char const *input("  () (( ) ()  ) ");
+
+		before_each([&]() {
+			decltype(bps)::from_string(bps, input);
+		});
+
+		it("finds closings", [&](){
+			AssertThat(bps.find_close(2),	Equals(3));
+			AssertThat(bps.find_close(5),	Equals(14));
+			AssertThat(bps.find_close(6),	Equals(8));
+			AssertThat(bps.find_close(10),	Equals(11));
+		});
+
+		it("finds openings", [&](){
+			AssertThat(bps.find_open(3),	Equals(2));
+			AssertThat(bps.find_open(14),	Equals(5));
+			AssertThat(bps.find_open(8),	Equals(6));
+			AssertThat(bps.find_open(11),	Equals(10));
+		});
+
+		it("has rank and select support", [&](){
+			AssertThat(bps.rank(5), Equals(2));
+			AssertThat(bps.select(2), Equals(5));
+		});
+	});
+	
+	describe("bp_support_sparse_il <>:", [](){
+
+		asm_lsw::bp_support_sparse_il <> bps;
+		char const *input("  () (( ) ()  ) ");
+
+		before_each([&]() {
+			decltype(bps)::from_string(bps, input);
+		});
+
+		it("finds closings", [&](){
+			AssertThat(bps.find_close(5),	Equals(14));
+			AssertThat(bps.find_close(10),	Equals(11));
+		});
+
+		it("finds enclosing parentheses", [&](){
+			AssertThat(bps.enclose(6),	Equals(5));
+			AssertThat(bps.enclose(10),	Equals(5));
+			AssertThat(bps.enclose(5),	Equals(bps.size()));
+		});
 	});
 });
@@ -0,0 +1,200 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/concurrent_y_fast_trie.hh>
+#include <algorithm>
+#include <bandit/bandit.h>
+#include <iterator>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace bandit;
+
+
+template <typename t_trie>
+void concurrent_set_type_tests()
+{
+	typedef typename t_trie::key_type key_type;
+	
+	it("works when empty", [](){
+		t_trie trie;
+		key_type key(0);
+		AssertThat(trie.size(), Equals(0));
+		AssertThat(trie.contains(0), Equals(false));
+		AssertThat(trie.find_predecessor(0, key, true), Equals(false));
+		AssertThat(trie.find_successor(0, key, true), Equals(false));
+	});
+	
+	it("returns the same values as std::set", [](){
+		t_trie trie;
+		std::set <key_type> ref;
+		key_type const max(std::numeric_limits <key_type>::max());
+		for (key_type i(3); i < max / 2; i += max / 64 + 3)
+		{
+			trie.insert(i);
+			ref.insert(i);
+		}
+		trie.synchronize();
+		
+		AssertThat(trie.size(), Equals(ref.size()));
+		
+		for (key_type i(0); i < max / 2; i += std::max <key_type>(max / 256, 1))
+		{
+			AssertThat(trie.contains(i), Equals(ref.count(i) == 1));
+			
+			key_type key(0);
+			auto const succ_it(ref.upper_bound(i));
+			AssertThat(trie.find_successor(i, key), Equals(ref.cend() != succ_it));
+			if (ref.cend() != succ_it)
+				AssertThat(key, Equals(*succ_it));
+			
+			auto const pred_it(ref.lower_bound(i));
+			AssertThat(trie.find_predecessor(i, key), Equals(ref.cbegin() != pred_it));
+			if (ref.cbegin() != pred_it)
+				AssertThat(key, Equals(*std::prev(pred_it)));
+		}
+	});
+	
+	it("reports whether the key was inserted", [](){
+		t_trie trie;
+		AssertThat(trie.insert(5), Equals(true));
+		AssertThat(trie.insert(5), Equals(false));
+		trie.synchronize();
+		AssertThat(trie.size(), Equals(1));
+	});
+	
+	it("can erase", [](){
+		t_trie trie;
+		trie.insert(5);
+		trie.insert(7);
+		AssertThat(trie.erase(5), Equals(true));
+		AssertThat(trie.erase(5), Equals(false));
+		trie.synchronize();
+		AssertThat(trie.contains(5), Equals(false));
+		AssertThat(trie.contains(7), Equals(true));
+	});
+	
+	it("publishes the changes when synchronized", [](){
+		t_trie trie(std::numeric_limits <key_type>::max(), 16);
+		trie.insert(5);
+		AssertThat(trie.contains(5), Equals(false));
+		trie.synchronize();
+		AssertThat(trie.contains(5), Equals(true));
+	});
+	
+	it("publishes the changes of one shard when synchronized with a key", [](){
+		t_trie trie(std::numeric_limits <key_type>::max(), 16);
+		key_type const max(std::numeric_limits <key_type>::max());
+		trie.insert(5);
+		trie.insert(max);
+		trie.synchronize(5);
+		AssertThat(trie.contains(5), Equals(true));
+		AssertThat(trie.contains(max), Equals(false));
+	});
+	
+	it("publishes the changes after the publish interval", [](){
+		t_trie trie(std::numeric_limits <key_type>::max(), 4);
+		for (key_type i(1); i < 4; ++i)
+			trie.insert(i);
+		AssertThat(trie.size(), Equals(0));
+		
+		// All the keys are in the same shard.
+		trie.insert(4);
+		AssertThat(trie.size(), Equals(4));
+		AssertThat(trie.contains(4), Equals(true));
+	});
+	
+	it("can be queried while inserting", [](){
+		t_trie trie;
+		key_type const count(std::numeric_limits <key_type>::max() < 4096 ? std::numeric_limits <key_type>::max() : 4096);
+		
+		std::thread writer([&trie, count](){
+			for (key_type i(1); i < count; ++i)
+				trie.insert(i);
+		});
+		
+		// The keys are inserted in increasing order, so a found successor
+		// of zero has to be one once it becomes visible.
+		std::vector <std::thread> readers;
+		std::vector <uint8_t> results(4, 1);
+		for (std::size_t i(0); i < results.size(); ++i)
+		{
+			readers.emplace_back([&trie, &results, i, count](){
+				for (key_type j(0); j < count; ++j)
+				{
+					key_type key(0);
+					if (trie.find_successor(0, key) && 1 != key)
+						results[i] = 0;
+				}
+			});
+		}
+		
+		writer.join();
+		for (auto &thread : readers)
+			thread.join();
+		
+		for (auto const res : results)
+			AssertThat(res, Equals(1));
+		
+		trie.synchronize();
+		AssertThat(trie.size(), Equals(count - 1));
+	});
+}
+
+
+go_bandit([](){
+	describe("concurrent Y-fast trie <uint8_t>:", [](){
+		concurrent_set_type_tests <asm_lsw::concurrent_y_fast_trie <uint8_t, void, 2>>();
+	});
+	
+	describe("concurrent Y-fast trie <uint32_t>:", [](){
+		concurrent_set_type_tests <asm_lsw::concurrent_y_fast_trie <uint32_t>>();
+	});
+	
+	describe("concurrent Y-fast trie <uint32_t, uint32_t>:", [](){
+		it("can find values", [](){
+			asm_lsw::concurrent_y_fast_trie <uint32_t, uint32_t> trie;
+			trie.insert(12, 5);
+			trie.synchronize();
+			uint32_t val(0);
+			AssertThat(trie.find(12, val), Equals(true));
+			AssertThat(val, Equals(5));
+			AssertThat(trie.find(13, val), Equals(false));
+		});
+		
+		it("keeps the existing value on insert", [](){
+			asm_lsw::concurrent_y_fast_trie <uint32_t, uint32_t> trie;
+			AssertThat(trie.insert(12, 5), Equals(true));
+			AssertThat(trie.insert(12, 6), Equals(false));
+			trie.synchronize();
+			uint32_t val(0);
+			AssertThat(trie.find(12, val), Equals(true));
+			AssertThat(val, Equals(5));
+		});
+		
+		it("replaces the existing value on insert_or_assign", [](){
+			asm_lsw::concurrent_y_fast_trie <uint32_t, uint32_t> trie;
+			AssertThat(trie.insert_or_assign(12, 5), Equals(true));
+			AssertThat(trie.insert_or_assign(12, 6), Equals(false));
+			trie.synchronize();
+			uint32_t val(0);
+			AssertThat(trie.find(12, val), Equals(true));
+			AssertThat(val, Equals(6));
+			AssertThat(trie.size(), Equals(1));
+		});
+	});
+});
@@ -0,0 +1,117 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/csa_access_cache.hh>
+#include <bandit/bandit.h>
+#include <vector>
+
+using namespace bandit;
+
+
+// Stands in for a CSA and counts the accesses.
+struct csa_stub
+{
+	typedef std::size_t size_type;
+	
+	struct isa_stub
+	{
+		std::vector <size_type> values;
+		mutable size_type accesses{0};
+		
+		size_type operator[](size_type const i) const { ++accesses; return values[i]; }
+		size_type size() const { return values.size(); }
+	};
+	
+	std::vector <size_type> values;
+	isa_stub isa;
+	mutable size_type accesses{0};
+	
+	csa_stub(std::vector <size_type> const &sa):
+		values(sa)
+	{
+		isa.values.resize(sa.size());
+		for (size_type i(0); i < sa.size(); ++i)
+			isa.values[sa[i]] = i;
+	}
+	
+	size_type operator[](size_type const i) const { ++accesses; return values[i]; }
+};
+
+
+go_bandit([](){
+	describe("csa_access_cache:", [](){
+		it("returns the SA and ISA values", [](){
+			csa_stub csa({7, 6, 4, 2, 0, 5, 3, 1});
+			asm_lsw::csa_access_cache <csa_stub, 2> cache;
+			cache.bind(csa, 1);
+			
+			for (std::size_t i(0); i < csa.values.size(); ++i)
+			{
+				AssertThat(cache.sa(i), Equals(csa.values[i]));
+				AssertThat(cache.isa(i), Equals(csa.isa.values[i]));
+			}
+		});
+		
+		it("reuses the values", [](){
+			csa_stub csa({7, 6, 4, 2, 0, 5, 3, 1});
+			asm_lsw::csa_access_cache <csa_stub, 2> cache;
+			cache.bind(csa, 1);
+			
+			AssertThat(cache.sa(3), Equals(2));
+			AssertThat(cache.sa(3), Equals(2));
+			AssertThat(cache.isa(2), Equals(3));
+			AssertThat(cache.isa(2), Equals(3));
+			AssertThat(csa.accesses, Equals(1));
+			AssertThat(csa.isa.accesses, Equals(1));
+			
+			// 7 maps to the same slot as 3.
+			AssertThat(cache.sa(7), Equals(1));
+			AssertThat(cache.sa(3), Equals(2));
+			AssertThat(csa.accesses, Equals(3));
+			
+			auto const &stats(cache.statistics());
+			AssertThat(stats.sa_hits, Equals(1));
+			AssertThat(stats.sa_misses, Equals(3));
+			AssertThat(stats.isa_hits, Equals(1));
+			AssertThat(stats.isa_misses, Equals(1));
+		});
+		
+		it("is cleared when the owner changes", [](){
+			csa_stub csa({7, 6, 4, 2, 0, 5, 3, 1});
+			asm_lsw::csa_access_cache <csa_stub, 2> cache;
+			cache.bind(csa, 1);
+			cache.sa(3);
+			cache.bind(csa, 1);
+			cache.sa(3);
+			AssertThat(csa.accesses, Equals(1));
+			
+			cache.bind(csa, 2);
+			cache.sa(3);
+			AssertThat(csa.accesses, Equals(2));
+		});
+		
+		it("prefetches without accessing the CSA", [](){
+			csa_stub csa({7, 6, 4, 2, 0, 5, 3, 1});
+			asm_lsw::csa_access_cache <csa_stub, 2> cache;
+			cache.bind(csa, 1);
+			
+			cache.prefetch_isa(3);
+			AssertThat(csa.isa.accesses, Equals(0));
+			AssertThat(cache.statistics().isa_misses, Equals(0));
+			AssertThat(cache.isa(3), Equals(csa.isa.values[3]));
+		});
+	});
+});
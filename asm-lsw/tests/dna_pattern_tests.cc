@@ -0,0 +1,154 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+#include <asm_lsw/dna_pattern.hh>
+#include <asm_lsw/k1_matcher.hh>
+#include <asm_lsw/k1_matcher_helper.hh>
+#include <asm_lsw/kn_matcher.hh>
+#include <bandit/bandit.h>
+#include <sdsl/csa_rao.hpp>
+#include <sdsl/csa_rao_builder.hpp>
+#include <string>
+
+using namespace bandit;
+
+
+go_bandit([](){
+	describe("dna_pattern:", [](){
+		it("converts the bases to upper case", [](){
+			std::string seq("ACGTacgt");
+			AssertThat(asm_lsw::dna_alphabet::normalize(seq), Equals(0));
+			
+			asm_lsw::dna_pattern const pattern(seq);
+			AssertThat(pattern.size(), Equals(seq.size()));
+			AssertThat(std::string(pattern.cbegin(), pattern.cend()), Equals("ACGTACGT"));
+		});
+		
+		it("replaces the ambiguity codes with a character outside the alphabet", [](){
+			std::string seq("ANRCGn");
+			AssertThat(asm_lsw::dna_alphabet::normalize(seq), Equals(3));
+			
+			asm_lsw::dna_pattern const pattern(seq);
+			char const n(asm_lsw::dna_alphabet::n_char);
+			AssertThat(std::string(pattern.cbegin(), pattern.cend()), Equals(std::string({'A', n, n, 'C', 'G', n})));
+		});
+	});
+	
+	describe("k1_matcher with dna_pattern:", [](){
+		typedef sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <4, 0>>, sdsl::lcp_support_sada <>> cst_type;
+		typedef asm_lsw::k1_matcher <cst_type> k1_matcher;
+		
+		cst_type cst;
+		k1_matcher matcher("ACGTTGCAACGTAGCTAGGATCCA", cst);
+		
+		for (std::string const seq : {"ACGTAG", "ACGTTC", "GCAAGTA", "TAGNAT", "CCNNCC"})
+		{
+			it(("reports the same results as with the unpacked pattern for " + seq).c_str(), [&, seq](){
+				std::string normalized(seq);
+				asm_lsw::dna_alphabet::normalize(normalized);
+				asm_lsw::dna_pattern const pattern(normalized);
+				
+				k1_matcher::csa_ranges expected, ranges;
+				matcher.find_1_approximate <true>(seq, expected);
+				matcher.find_1_approximate <true>(pattern, ranges);
+				asm_lsw::util::post_process_ranges(expected);
+				asm_lsw::util::post_process_ranges(ranges);
+				
+				AssertThat(ranges, Equals(expected));
+			});
+		}
+	});
+	
+	describe("kn_matcher with dna_pattern:", [](){
+		typedef sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <4, 0>>, sdsl::lcp_support_sada <>> cst_type;
+		typedef asm_lsw::kn_matcher <cst_type> kn_matcher;
+		
+		cst_type cst;
+		{
+			asm_lsw::k1_matcher <cst_type> k1_matcher("GATTACAACGTTGCAACGTAGCTAGGATCCATTACGGA", cst);
+		}
+		kn_matcher matcher(cst);
+		
+		for (std::string const seq : {"GATTACA", "ACGTTCCAACG", "TAGCTTGGAT", "CANCGTAG", "TTNNGCAA"})
+		{
+			for (uint8_t k(1); k <= 3; ++k)
+			{
+				it(("reports the same results as with the unpacked pattern for " + seq + " with k = " + std::to_string(+k)).c_str(), [&, seq, k](){
+					std::string normalized(seq);
+					asm_lsw::dna_alphabet::normalize(normalized);
+					asm_lsw::dna_pattern const pattern(normalized);
+					
+					kn_matcher::csa_ranges expected, ranges;
+					matcher.find_approximate <true>(seq, k, expected);
+					matcher.find_approximate <true>(pattern, k, ranges);
+					asm_lsw::util::post_process_ranges(expected);
+					asm_lsw::util::post_process_ranges(ranges);
+					
+					AssertThat(ranges, Equals(expected));
+				});
+			}
+		}
+	});
+	
+	describe("dna_pattern with a text that contains N:", [](){
+		typedef sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <4, 0>>, sdsl::lcp_support_sada <>> cst_type;
+		typedef asm_lsw::kn_matcher <cst_type> kn_matcher;
+		
+		cst_type cst;
+		{
+			asm_lsw::k1_matcher <cst_type> k1_matcher("ACGTNACGTTGCA", cst);
+		}
+		kn_matcher matcher(cst);
+		
+		it("does not match N in the read with N in the text", [&](){
+			std::string const seq("GTNAC");
+			std::string normalized(seq);
+			asm_lsw::dna_alphabet::normalize(normalized);
+			asm_lsw::dna_pattern const pattern(normalized);
+			
+			cst_type::size_type lb(0), rb(0);
+			AssertThat(sdsl::backward_search(cst.csa, 0, cst.csa.size() - 1, seq.cbegin(), seq.cend(), lb, rb), Equals(1));
+			AssertThat(sdsl::backward_search(cst.csa, 0, cst.csa.size() - 1, pattern.cbegin(), pattern.cend(), lb, rb), Equals(0));
+		});
+		
+		it("does not substitute N in the text for a base", [&](){
+			// GTNAC is the only substring within one difference.
+			std::string const seq("GTGAC");
+			asm_lsw::dna_pattern const pattern(seq);
+			
+			kn_matcher::csa_ranges plain_ranges, ranges;
+			matcher.find_approximate <true>(seq, 1, plain_ranges);
+			matcher.find_approximate <true>(pattern, 1, ranges);
+			
+			AssertThat(plain_ranges.empty(), Equals(false));
+			AssertThat(ranges.empty(), Equals(true));
+		});
+		
+		it("matches the bases around N in the text", [&](){
+			std::string const seq("ACGTTGCA");
+			asm_lsw::dna_pattern const pattern(seq);
+			
+			kn_matcher::csa_ranges expected, ranges;
+			matcher.find_approximate <true>(seq, 1, expected);
+			matcher.find_approximate <true>(pattern, 1, ranges);
+			asm_lsw::util::post_process_ranges(expected);
+			asm_lsw::util::post_process_ranges(ranges);
+			
+			AssertThat(ranges.empty(), Equals(false));
+			AssertThat(ranges, Equals(expected));
+		});
+	});
+});
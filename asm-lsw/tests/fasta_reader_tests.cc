@@ -0,0 +1,110 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+
+#include <asm_lsw/fasta_reader.hh>
+#include <bandit/bandit.h>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace bandit;
+
+
+namespace {
+	
+	// Collect the sequences and the number of chunks.
+	struct chunk_collector
+	{
+		std::vector <std::pair <std::string, std::string>> sequences;
+		std::size_t chunk_count{0};
+		bool finished{false};
+		
+		void begin_sequence(std::string const &identifier) { sequences.emplace_back(identifier, std::string()); }
+		void end_sequence() {}
+		void finish() { finished = true; }
+		
+		void handle_chunk(char const *data, std::size_t const size)
+		{
+			sequences.back().second.append(data, size);
+			++chunk_count;
+		}
+	};
+	
+	
+	template <std::size_t t_buffer_size>
+	chunk_collector read_chunks(std::string const &input)
+	{
+		std::istringstream stream(input);
+		chunk_collector cb;
+		asm_lsw::fasta_chunk_reader <chunk_collector, t_buffer_size> reader;
+		reader.read_from_stream(stream, cb);
+		return cb;
+	}
+}
+
+
+go_bandit([](){
+	describe("fasta_chunk_reader:", [](){
+		it("reads the sequences one line at a time", [](){
+			auto const cb(read_chunks <1024>(">seq1\nACGT\nGGCC\n;comment\n>seq2\nTTAA\n"));
+			
+			AssertThat(cb.finished, Equals(true));
+			AssertThat(cb.sequences.size(), Equals(2));
+			AssertThat(cb.sequences[0].first, Equals("seq1"));
+			AssertThat(cb.sequences[0].second, Equals("ACGTGGCC"));
+			AssertThat(cb.sequences[1].first, Equals("seq2"));
+			AssertThat(cb.sequences[1].second, Equals("TTAA"));
+			AssertThat(cb.chunk_count, Equals(3));
+		});
+		
+		it("reads a sequence without a header or a terminating newline", [](){
+			auto const cb(read_chunks <1024>("ACGT\nGG"));
+			
+			AssertThat(cb.sequences.size(), Equals(1));
+			AssertThat(cb.sequences[0].first, Equals(""));
+			AssertThat(cb.sequences[0].second, Equals("ACGTGG"));
+		});
+		
+		it("does not truncate lines longer than the buffer", [](){
+			std::string const line("ACGTTGCAACGTAGCTAGGATCCA");
+			auto const cb(read_chunks <8>(">seq1\n" + line + "\nGATTACA\n>seq2\n" + line));
+			
+			AssertThat(cb.sequences.size(), Equals(2));
+			AssertThat(cb.sequences[0].first, Equals("seq1"));
+			AssertThat(cb.sequences[0].second, Equals(line + "GATTACA"));
+			AssertThat(cb.sequences[1].first, Equals("seq2"));
+			AssertThat(cb.sequences[1].second, Equals(line));
+		});
+		
+		it("handles lines that exactly fill the buffer", [](){
+			auto const cb(read_chunks <8>(">s\nACGTACG\nTTTTTTTT\n"));
+			
+			AssertThat(cb.sequences.size(), Equals(1));
+			AssertThat(cb.sequences[0].second, Equals("ACGTACGTTTTTTTT"));
+		});
+		
+		it("joins the parts of long headers and comments", [](){
+			std::string const identifier("a_rather_long_sequence_identifier");
+			auto const cb(read_chunks <8>(";a rather long comment line\n>" + identifier + "\nACGT\n"));
+			
+			AssertThat(cb.sequences.size(), Equals(1));
+			AssertThat(cb.sequences[0].first, Equals(identifier));
+			AssertThat(cb.sequences[0].second, Equals("ACGT"));
+		});
+	});
+});
@@ -22,6 +22,10 @@
 #include <boost/iostreams/stream.hpp>
 #include <sdsl/csa_rao.hpp>
 #include <sdsl/csa_rao_builder.hpp>
+#include <sdsl/csa_sada.hpp>
+#include <sdsl/lcp_bitcompressed.hpp>
+#include <set>
+#include <sstream>
 
 using namespace bandit;
 
@@ -116,7 +120,86 @@ void typed_tests(t_input_pattern const &ip)
 				
 				AssertThat(ranges, Equals(p.ranges));
 			});
+			
+			it(("reports results correctly with a child table for " + p.pattern).c_str(), [&](){
+				sdsl::int_vector <0> pattern(p.pattern.size());
+				std::copy(p.pattern.cbegin(), p.pattern.cend(), pattern.begin());
+				
+				t_matcher table_matcher(cst, true, 3);
+				AssertThat(table_matcher.child_table().size(), IsGreaterThan(0));
+				
+				typename t_matcher::csa_ranges ranges;
+				table_matcher.template find_1_approximate <true>(pattern, ranges);
+				asm_lsw::util::post_process_ranges(ranges);
+				
+				AssertThat(ranges, Equals(p.ranges));
+			});
+			
+			it(("reports results correctly with concurrently loaded components for " + p.pattern).c_str(), [&](){
+				sdsl::int_vector <0> pattern(p.pattern.size());
+				std::copy(p.pattern.cbegin(), p.pattern.cend(), pattern.begin());
+				
+				typedef typename t_matcher::component component;
+				std::vector <std::string> serialized(t_matcher::s_component_count);
+				for (std::size_t i(0); i < t_matcher::s_component_count; ++i)
+				{
+					std::ostringstream stream;
+					matcher.serialize_component(static_cast <component>(i), stream);
+					serialized[i] = stream.str();
+				}
+				
+				t_matcher loaded_matcher(cst, false);
+				loaded_matcher.load_components([&](component const c){
+					return std::unique_ptr <std::istream>(new std::istringstream(serialized[static_cast <std::size_t>(c)]));
+				}, 2);
+				
+				typename t_matcher::csa_ranges ranges;
+				loaded_matcher.template find_1_approximate <true>(pattern, ranges);
+				asm_lsw::util::post_process_ranges(ranges);
+				
+				AssertThat(ranges, Equals(p.ranges));
+			});
+			
+			it(("constructs the F arrays with backward search for " + p.pattern).c_str(), [&](){
+				sdsl::int_vector <0> pattern(p.pattern.size());
+				std::copy(p.pattern.cbegin(), p.pattern.cend(), pattern.begin());
+				
+				typedef typename t_matcher::f_type f_type;
+				f_type const f(matcher, pattern);
+				f_type const f_ref(matcher, pattern, typename f_type::forward_search_tag());
+				
+				AssertThat(f.size(), Equals(f_ref.size()));
+				for (typename f_type::size_type i(0); i < f.size(); ++i)
+				{
+					AssertThat(f.st(cst, i), Equals(f_ref.st(cst, i)));
+					AssertThat(f.ed(cst, i), Equals(f_ref.ed(cst, i)));
+				}
+			});
 		}
+		
+		it("allocates the gamma and H tries from its arena", [&](){
+			// The tries are built on worker threads, which need to make the arena current.
+			auto const bytes_before(asm_lsw::pool_allocator_arena::bytes_allocated_without_arena());
+			
+			typename t_matcher::cst_type arena_cst;
+			t_matcher arena_matcher(ip.input, arena_cst);
+			
+			AssertThat(arena_matcher.arena(), Is().Not().EqualTo(nullptr));
+			AssertThat(asm_lsw::pool_allocator_arena::bytes_allocated_without_arena(), Equals(bytes_before));
+		});
+		
+		it("does not look up nodes deeper than the tabulated depth in the child table", [&](){
+			t_matcher table_matcher(cst, true, 3);
+			auto const &table(table_matcher.child_table());
+			auto const c(cst.csa.comp2char[1]);
+			
+			typename t_matcher::cst_type::node_type w{}, w_ref{};
+			typename t_matcher::cst_type::size_type char_pos(0);
+			AssertThat(table.child(cst, cst.root(), 0, c, w), Equals(true));
+			w_ref = cst.child(cst.root(), c, char_pos);
+			AssertThat(w, Equals(w_ref));
+			AssertThat(table.child(cst, cst.root(), 4, c, w), Equals(false));
+		});
 	});
 }
 
@@ -170,7 +253,121 @@ void typed_tests()
 }
 
 
+void search_monotone_tests()
+{
+	typedef asm_lsw::util::search_direction search_direction;
+	
+	auto const compare_fn([](std::vector <uint32_t> const &vec, uint32_t const val, std::size_t &probe_count){
+		return [&vec, val, &probe_count](uint32_t const mid){
+			++probe_count;
+			if (vec[mid] < val)
+				return search_direction::right;
+			if (val < vec[mid])
+				return search_direction::left;
+			return search_direction::found;
+		};
+	});
+	
+	it("finds every value with a logarithmic number of probes", [compare_fn](){
+		for (uint32_t size(1); size <= 64; ++size)
+		{
+			std::vector <uint32_t> vec(size);
+			for (uint32_t i(0); i < size; ++i)
+				vec[i] = 2 * i + 1;
+			
+			std::size_t const max_probes(sdsl::bits::hi(size) + 1);
+			for (uint32_t i(0); i < size; ++i)
+			{
+				std::size_t probe_count(0);
+				uint32_t idx(0);
+				AssertThat(asm_lsw::util::search_monotone(uint32_t(0), size - 1, idx, compare_fn(vec, vec[i], probe_count)), Equals(true));
+				AssertThat(idx, Equals(i));
+				AssertThat(probe_count, Is().LessThanOrEqualTo(max_probes));
+			}
+		}
+	});
+	
+	it("does not find missing values", [compare_fn](){
+		for (uint32_t size(1); size <= 64; ++size)
+		{
+			std::vector <uint32_t> vec(size);
+			for (uint32_t i(0); i < size; ++i)
+				vec[i] = 2 * i + 1;
+			
+			// Includes the values before the first and after the last one.
+			for (uint32_t val(0); val <= 2 * size; val += 2)
+			{
+				std::size_t probe_count(0);
+				uint32_t idx(0);
+				AssertThat(asm_lsw::util::search_monotone(uint32_t(0), size - 1, idx, compare_fn(vec, val, probe_count)), Equals(false));
+			}
+		}
+	});
+	
+	it("stops when requested", [](){
+		std::size_t probe_count(0);
+		uint32_t idx(0);
+		auto const res(asm_lsw::util::search_monotone(uint32_t(0), uint32_t(100), idx, [&probe_count](uint32_t const mid){
+			++probe_count;
+			return search_direction::stop;
+		}));
+		AssertThat(res, Equals(false));
+		AssertThat(probe_count, Equals(1));
+	});
+	
+	it("probes the same indices with the batched search after prefetching them", [](){
+		for (uint32_t size(1); size <= 64; ++size)
+		{
+			std::vector <uint32_t> vec(size);
+			for (uint32_t i(0); i < size; ++i)
+				vec[i] = 2 * i + 1;
+			
+			// Both the present and the missing values.
+			for (uint32_t val(0); val <= 2 * size; ++val)
+			{
+				std::vector <uint32_t> expected_probes, probes;
+				std::set <uint32_t> prefetched;
+				auto const probe_fn([&vec, val](uint32_t const mid){
+					if (vec[mid] < val)
+						return search_direction::right;
+					if (val < vec[mid])
+						return search_direction::left;
+					return search_direction::found;
+				});
+				
+				uint32_t expected_idx(0), idx(0);
+				auto const expected(asm_lsw::util::search_monotone(uint32_t(0), size - 1, expected_idx, [&](uint32_t const mid){
+					expected_probes.push_back(mid);
+					return probe_fn(mid);
+				}));
+				
+				bool prefetched_all(true);
+				auto const res(asm_lsw::util::search_monotone_batched(uint32_t(0), size - 1, idx, [&](uint32_t const j){
+					AssertThat(j, Is().LessThan(size));
+					prefetched.insert(j);
+				}, [&](uint32_t const mid){
+					probes.push_back(mid);
+					if (!prefetched.count(mid))
+						prefetched_all = false;
+					return probe_fn(mid);
+				}));
+				
+				AssertThat(res, Equals(expected));
+				AssertThat(probes, Equals(expected_probes));
+				AssertThat(prefetched_all, Equals(true));
+				if (expected)
+					AssertThat(idx, Equals(expected_idx));
+			}
+		}
+	});
+}
+
+
 go_bandit([](){
+	describe("util::search_monotone:", [](){
+		search_monotone_tests();
+	});
+	
 	describe("k1_matcher <cst_sada <>> (without serialization):", [](){
 		typed_tests <sdsl::cst_sada <>, false>();
 	});
@@ -179,6 +376,10 @@ go_bandit([](){
 		typed_tests <sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <4, 0>>, sdsl::lcp_support_sada <>>, false>();
 	});
 	
+	describe("k1_matcher <sdsl::cst_sada <sdsl::csa_sada <sdsl::enc_vector <>, 8, 8>, sdsl::lcp_bitcompressed <>>> (without serialization):", [](){
+		typed_tests <sdsl::cst_sada <sdsl::csa_sada <sdsl::enc_vector <>, 8, 8>, sdsl::lcp_bitcompressed <>>, false>();
+	});
+	
 	describe("k1_matcher <cst_sada <>> (with serialization):", [](){
 		typed_tests <sdsl::cst_sada <>, true>();
 	});
@@ -186,4 +387,8 @@ go_bandit([](){
 	describe("k1_matcher <sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <4, 0>>, sdsl::lcp_support_sada <>>> (with serialization):", [](){
 		typed_tests <sdsl::cst_sada <sdsl::csa_rao <sdsl::csa_rao_spec <4, 0>>, sdsl::lcp_support_sada <>>, true>();
 	});
+	
+	describe("k1_matcher <sdsl::cst_sada <sdsl::csa_sada <sdsl::enc_vector <>, 8, 8>, sdsl::lcp_bitcompressed <>>> (with serialization):", [](){
+		typed_tests <sdsl::cst_sada <sdsl::csa_sada <sdsl::enc_vector <>, 8, 8>, sdsl::lcp_bitcompressed <>>, true>();
+	});
 });
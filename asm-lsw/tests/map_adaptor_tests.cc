@@ -17,14 +17,17 @@
 #include <asm_lsw/map_adaptors.hh>
 #include <asm_lsw/pool_allocator.hh>
 #include <asm_lsw/util.hh>
+#include <algorithm>
 #include <bandit/bandit.h>
 #include <boost/format.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <limits>
 #include <sdsl/io.hpp>
 #include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 using namespace bandit;
 
@@ -66,6 +69,8 @@ struct test_traits
 	typedef typename access_key::accessed_type accessed_type;
 	typedef typename asm_lsw::detail::map_adaptor_hash <access_key, std::hash <accessed_type>> hash;
 	typedef typename asm_lsw::detail::map_adaptor_key_equal <access_key, std::equal_to <accessed_type>> key_equal;
+	
+	static t_key make_key(accessed_type const &acc) { return acc; }
 };
 
 
@@ -73,8 +78,11 @@ template <typename t_access_key>
 struct test_traits <pair, t_access_key>
 {
 	typedef pair_access_key access_key;
+	typedef typename access_key::accessed_type accessed_type;
 	typedef typename asm_lsw::detail::map_adaptor_hash <access_key, std::hash <uint32_t>> hash;
 	typedef typename asm_lsw::detail::map_adaptor_key_equal <access_key, std::equal_to <uint32_t>> key_equal;
+	
+	static pair make_key(accessed_type const &acc) { return pair{acc, 0}; }
 };
 
 
@@ -246,6 +254,80 @@ void phf_tests(t_adaptor const &adaptor, t_map const &test_values, t_test_specia
 		test_spec.test_access_key(adaptor, test_values);
 	});
 	
+	it("can find multiple objects at a time", [&](){
+		typedef typename t_adaptor::trait_type trait_type;
+		std::vector <typename t_adaptor::key_type> keys;
+		for (auto const &kv : test_values)
+			keys.push_back(trait_type::key(kv));
+		
+		std::vector <typename t_adaptor::size_type> indices;
+		adaptor.find_many(keys, indices);
+		AssertThat(indices.size(), Equals(keys.size()));
+		
+		auto const &acc(adaptor.access_key_fn());
+		for (std::size_t i(0); i < keys.size(); ++i)
+		{
+			AssertThat(indices[i], Is().LessThan(adaptor.map().size()));
+			AssertThat(acc(trait_type::key(adaptor[indices[i]])), Equals(acc(keys[i])));
+		}
+	});
+	
+	it("can report the missing keys when finding multiple objects", [&](){
+		typedef typename t_adaptor::trait_type trait_type;
+		typedef typename t_adaptor::accessed_type accessed_type;
+		typedef test_traits <typename t_adaptor::key_type> test_trait_type;
+		
+		auto const &acc(adaptor.access_key_fn());
+		std::unordered_set <accessed_type> present;
+		for (auto const &kv : test_values)
+			present.insert(acc(trait_type::key(kv)));
+		
+		// Take the neighbours of the present keys and the ends of the key range.
+		auto const max_acc(std::numeric_limits <accessed_type>::max());
+		std::vector <accessed_type> candidates{0, 1, accessed_type(max_acc - 1), max_acc};
+		for (auto const a : present)
+		{
+			candidates.push_back(a - 1);
+			candidates.push_back(a + 1);
+		}
+		
+		std::vector <accessed_type> absent;
+		for (auto const a : candidates)
+		{
+			if (!present.count(a) && absent.cend() == std::find(absent.cbegin(), absent.cend(), a))
+				absent.push_back(a);
+		}
+		
+		// Mix the absent keys with the present ones s.t. the batches contain both.
+		std::vector <typename t_adaptor::key_type> keys;
+		auto absent_it(absent.cbegin());
+		for (auto const &kv : test_values)
+		{
+			keys.push_back(trait_type::key(kv));
+			if (absent_it != absent.cend())
+				keys.push_back(test_trait_type::make_key(*absent_it++));
+		}
+		while (absent_it != absent.cend())
+			keys.push_back(test_trait_type::make_key(*absent_it++));
+		
+		std::vector <typename t_adaptor::size_type> indices;
+		adaptor.find_many(keys, indices);
+		AssertThat(indices.size(), Equals(keys.size()));
+		
+		for (std::size_t i(0); i < keys.size(); ++i)
+		{
+			if (present.count(acc(keys[i])))
+			{
+				AssertThat(indices[i], Is().LessThan(adaptor.map().size()));
+				AssertThat(acc(trait_type::key(adaptor[indices[i]])), Equals(acc(keys[i])));
+			}
+			else
+			{
+				AssertThat(indices[i], Equals(adaptor.map().size()));
+			}
+		}
+	});
+	
 	it("can serialize", [&](){
 		std::size_t const buffer_size(4096);
 		char buffer[buffer_size];
@@ -297,6 +379,41 @@ void test_adaptors(t_map <t_args ...> const &test_values)
 			phf_tests(adaptor, test_values, test_spec);
 		});
 	}
+	
+	{
+		// Minimal perfect hashing with compressed slots.
+		typedef asm_lsw::map_adaptor_mphf_spec <
+			std::vector, asm_lsw::pool_allocator, key_type, value_type, true, typename test_traits <key_type>::access_key
+		> adaptor_spec;
+		auto tv_copy(test_values);
+		asm_lsw::map_adaptor_phf_builder <adaptor_spec, decltype(test_values)> builder(tv_copy);
+		
+		describe(boost::str(boost::format("%s (compressed slots):") % typeid(typename decltype(builder)::adaptor_type).name()).c_str(), [&](){
+			typename decltype(builder)::adaptor_type adaptor(builder);
+			
+			it("has one slot per element", [&](){
+				AssertThat(adaptor.map().size(), Equals(test_values.size()));
+			});
+			
+			common_tests(adaptor, test_values, test_spec);
+			phf_tests(adaptor, test_values, test_spec);
+		});
+	}
+	
+	{
+		// Non-default PHF parameters with the parallel builder.
+		typedef asm_lsw::map_adaptor_phf_spec <
+			std::vector, asm_lsw::pool_allocator, key_type, value_type, true, typename test_traits <key_type>::access_key, 2, 95, 1
+		> adaptor_spec;
+		auto tv_copy(test_values);
+		asm_lsw::map_adaptor_phf_parallel_builder <adaptor_spec, decltype(test_values)> builder(tv_copy, 4);
+		
+		describe(boost::str(boost::format("%s (parallel builder):") % typeid(typename decltype(builder)::adaptor_type).name()).c_str(), [&](){
+			typename decltype(builder)::adaptor_type adaptor(builder.builder());
+			common_tests(adaptor, test_values, test_spec);
+			phf_tests(adaptor, test_values, test_spec);
+		});
+	}
 }
 
 
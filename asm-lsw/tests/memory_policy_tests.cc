@@ -0,0 +1,94 @@
+/*
+ Copyright (c) 2016 Tuukka Norri
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see http://www.gnu.org/licenses/ .
+ */
+
+
+#include <asm_lsw/memory_policy.hh>
+#include <asm_lsw/pool_allocator.hh>
+#include <bandit/bandit.h>
+#include <ostream>
+#include <sdsl/int_vector.hpp>
+#include <vector>
+
+using namespace bandit;
+
+
+go_bandit([](){
+	describe("memory_policy_scope:", [](){
+		it("sets and restores the huge page setting of the arenas", [](){
+			AssertThat(asm_lsw::pool_allocator_arena::huge_pages_by_default(), Equals(false));
+			
+			{
+				asm_lsw::memory_policy_scope scope(asm_lsw::huge_page_policy::transparent, asm_lsw::numa_policy::none);
+				AssertThat(scope.huge_pages_enabled(), Equals(true));
+				AssertThat(scope.numa_policy_set(), Equals(false));
+				AssertThat(asm_lsw::pool_allocator_arena::huge_pages_by_default(), Equals(true));
+			}
+			
+			AssertThat(asm_lsw::pool_allocator_arena::huge_pages_by_default(), Equals(false));
+		});
+		
+		it("does nothing without a policy", [](){
+			sdsl::int_vector <8> vec(4 * asm_lsw::memory_policy_scope::s_huge_page_size, 1);
+			
+			asm_lsw::memory_policy_scope scope(asm_lsw::huge_page_policy::none, asm_lsw::numa_policy::none);
+			AssertThat(scope.huge_pages_enabled(), Equals(false));
+			AssertThat(asm_lsw::pool_allocator_arena::huge_pages_by_default(), Equals(false));
+			AssertThat(scope.advise_loaded_memory(vec), Equals(0));
+			AssertThat(scope.advise_range(vec.data(), 4 * asm_lsw::memory_policy_scope::s_huge_page_size), Equals(false));
+		});
+		
+		it("keeps the contents of the advised memory", [](){
+			std::size_t const size(4 * asm_lsw::memory_policy_scope::s_huge_page_size);
+			sdsl::int_vector <8> vec(size);
+			for (std::size_t i(0); i < size; ++i)
+				vec[i] = i % 251;
+			
+			asm_lsw::memory_policy_scope scope(asm_lsw::huge_page_policy::transparent, asm_lsw::numa_policy::none);
+			
+			// The kernel may have been configured without transparent huge pages,
+			// so the number of ranges advised is not checked.
+			scope.advise_loaded_memory(vec);
+			
+			for (std::size_t i(0); i < size; ++i)
+			{
+				if (vec[i] != i % 251)
+					AssertThat(vec[i], Equals(i % 251));
+			}
+		});
+	});
+	
+	describe("address_range_streambuf:", [](){
+		it("records the memory written to it", [](){
+			std::vector <char> buffer(1000);
+			uint64_t const value(1);
+			
+			asm_lsw::detail::address_range_streambuf buf;
+			std::ostream stream(&buf);
+			stream.write(buffer.data(), 400);
+			stream.write(buffer.data() + 400, 600);
+			stream.write(reinterpret_cast <char const *>(&value), sizeof(value));
+			
+			auto const &ranges(buf.ranges());
+			uintptr_t const start(reinterpret_cast <uintptr_t>(buffer.data()));
+			uintptr_t const value_start(reinterpret_cast <uintptr_t>(&value));
+			AssertThat(ranges.size(), Equals(2));
+			AssertThat(ranges[0].first, Equals(start));
+			AssertThat(ranges[0].second, Equals(start + 1000));
+			AssertThat(ranges[1].first, Equals(value_start));
+			AssertThat(ranges[1].second, Equals(value_start + sizeof(value)));
+		});
+	});
+});
@@ -17,6 +17,7 @@
 
 #include <asm_lsw/pool_allocator.hh>
 #include <bandit/bandit.h>
+#include <thread>
 #include <vector>
 
 using namespace bandit;
@@ -94,6 +95,127 @@ void common_tests()
 }
 
 
+void arena_tests()
+{
+	it("allocates pools from the current arena", [](){
+		std::shared_ptr <asm_lsw::pool_allocator_arena> arena(new asm_lsw::pool_allocator_arena(1024));
+		
+		{
+			asm_lsw::pool_allocator_arena::scope scope(arena);
+			asm_lsw::pool_allocator <uint64_t> allocator_1((std::size_t) 8);
+			asm_lsw::pool_allocator <uint8_t> allocator_2((std::size_t) 3);
+			AssertThat(arena->bytes_used(), Equals(8 * sizeof(uint64_t) + 3));
+			AssertThat(arena->block_count(), Equals(1));
+			
+			auto *ptr(allocator_1.allocate(8));
+			AssertThat(reinterpret_cast <uintptr_t>(ptr) % alignof(uint64_t), Equals(0));
+		}
+		
+		AssertThat(asm_lsw::pool_allocator_arena::current().get(), Equals(nullptr));
+	});
+	
+	it("allocates for default-constructed allocators", [](){
+		std::shared_ptr <asm_lsw::pool_allocator_arena> arena(new asm_lsw::pool_allocator_arena(64));
+		asm_lsw::pool_allocator_arena::scope scope(arena);
+		
+		std::vector <uint32_t, asm_lsw::pool_allocator <uint32_t>> vec;
+		for (uint32_t i(0); i < 100; ++i)
+			vec.push_back(i);
+		
+		for (uint32_t i(0); i < 100; ++i)
+			AssertThat(vec[i], Equals(i));
+		
+		// The large requests are allocated in separate blocks.
+		AssertThat(arena->block_count(), Is().GreaterThan(1));
+		AssertThat(arena->bytes_reserved(), Is().GreaterThanOrEqualTo(arena->bytes_used()));
+	});
+	
+	it("keeps the memory while allocators refer to it", [](){
+		std::vector <uint32_t, asm_lsw::pool_allocator <uint32_t>> vec;
+		
+		{
+			std::shared_ptr <asm_lsw::pool_allocator_arena> arena(new asm_lsw::pool_allocator_arena());
+			asm_lsw::pool_allocator_arena::scope scope(arena);
+			std::vector <uint32_t, asm_lsw::pool_allocator <uint32_t>> tmp(10, 7);
+			vec = std::move(tmp);
+		}
+		
+		AssertThat(vec.size(), Equals(10));
+		AssertThat(vec[9], Equals(7));
+	});
+	
+	it("reuses the most recent allocation after deallocation", [](){
+		std::shared_ptr <asm_lsw::pool_allocator_arena> arena(new asm_lsw::pool_allocator_arena(1024));
+		asm_lsw::pool_allocator_arena::scope scope(arena);
+		
+		asm_lsw::pool_allocator <uint64_t> allocator;
+		auto *ptr_1(allocator.allocate(4));
+		auto *ptr_2(allocator.allocate(4));
+		AssertThat(arena->bytes_used(), Equals(8 * sizeof(uint64_t)));
+		
+		// Only the last allocation can be returned.
+		allocator.deallocate(ptr_1, 4);
+		AssertThat(arena->bytes_used(), Equals(8 * sizeof(uint64_t)));
+		allocator.deallocate(ptr_2, 4);
+		AssertThat(arena->bytes_used(), Equals(4 * sizeof(uint64_t)));
+		AssertThat(allocator.allocate(4), Equals(ptr_2));
+	});
+	
+	it("keeps the scopes of different threads separate", [](){
+		std::size_t const count(1000);
+		std::vector <std::shared_ptr <asm_lsw::pool_allocator_arena>> arenas{
+			std::shared_ptr <asm_lsw::pool_allocator_arena>(new asm_lsw::pool_allocator_arena(1024)),
+			std::shared_ptr <asm_lsw::pool_allocator_arena>(new asm_lsw::pool_allocator_arena(1024))
+		};
+		std::vector <asm_lsw::pool_allocator_arena *> seen_arenas(arenas.size(), nullptr);
+		
+		std::vector <std::thread> threads;
+		for (std::size_t i(0); i < arenas.size(); ++i)
+		{
+			threads.emplace_back([&arenas, &seen_arenas, i, count](){
+				asm_lsw::pool_allocator_arena::scope scope(arenas[i]);
+				for (std::size_t j(0); j < count; ++j)
+				{
+					asm_lsw::pool_allocator <uint32_t> allocator((std::size_t) 1);
+					allocator.allocate(1);
+					std::this_thread::yield();
+				}
+				seen_arenas[i] = asm_lsw::pool_allocator_arena::current().get();
+			});
+		}
+		
+		for (auto &thread : threads)
+			thread.join();
+		
+		for (std::size_t i(0); i < arenas.size(); ++i)
+		{
+			AssertThat(seen_arenas[i], Equals(arenas[i].get()));
+			AssertThat(arenas[i]->bytes_used(), Equals(count * sizeof(uint32_t)));
+		}
+		AssertThat(asm_lsw::pool_allocator_arena::current().get(), Equals(nullptr));
+	});
+	
+	it("counts the bytes allocated without an arena", [](){
+		auto const bytes_before(asm_lsw::pool_allocator_arena::bytes_allocated_without_arena());
+		
+		{
+			std::shared_ptr <asm_lsw::pool_allocator_arena> arena(new asm_lsw::pool_allocator_arena(1024));
+			asm_lsw::pool_allocator_arena::scope scope(arena);
+			asm_lsw::pool_allocator <uint32_t> allocator;
+			allocator.allocate(4);
+			asm_lsw::pool_allocator <uint32_t> pool_allocator((std::size_t) 4);
+		}
+		AssertThat(asm_lsw::pool_allocator_arena::bytes_allocated_without_arena(), Equals(bytes_before));
+		
+		asm_lsw::pool_allocator <uint32_t> allocator;
+		auto *ptr(allocator.allocate(4));
+		allocator.deallocate(ptr, 4);
+		asm_lsw::pool_allocator <uint32_t> pool_allocator((std::size_t) 2);
+		AssertThat(asm_lsw::pool_allocator_arena::bytes_allocated_without_arena(), Equals(bytes_before + 6 * sizeof(uint32_t)));
+	});
+}
+
+
 go_bandit([](){
 	describe("pool_allocator<uint8_t>:", [](){
 		typed_tests <uint8_t>();
@@ -106,4 +228,8 @@ go_bandit([](){
 	describe("pool_allocator", [](){
 		common_tests();
 	});
+	
+	describe("pool_allocator_arena", [](){
+		arena_tests();
+	});
 });
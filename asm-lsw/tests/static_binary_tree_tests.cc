@@ -19,7 +19,9 @@
 #include <bandit/bandit.h>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <initializer_list>
 #include <iostream>
+#include <set>
 
 using namespace bandit;
 
@@ -69,7 +71,12 @@ struct trait <t_key, void>
 };
 
 
-template <typename t_key, typename t_value, typename t_vec>
+template <
+	typename t_key,
+	typename t_value,
+	asm_lsw::static_binary_tree_layout t_layout = asm_lsw::static_binary_tree_layout::bfs,
+	typename t_vec
+>
 void static_binary_tree_tests(t_vec vec, t_key lower, t_key expected) // Copy.
 {
 	typedef trait <t_key, t_value> trait_type;
@@ -80,7 +87,7 @@ void static_binary_tree_tests(t_vec vec, t_key lower, t_key expected) // Copy.
 		ref_set.insert(v);
 	auto const max_key(trait.key(ref_set.crbegin()));
 	
-	typedef asm_lsw::static_binary_tree <t_key, t_value, true> tree_type;
+	typedef asm_lsw::static_binary_tree <t_key, t_value, true, t_layout> tree_type;
 	auto const size(vec.size());
 	tree_type tree(vec);
 	
@@ -115,6 +122,16 @@ void static_binary_tree_tests(t_vec vec, t_key lower, t_key expected) // Copy.
 		auto const it(tree.lower_bound(lower));
 		AssertThat(it, Is().Not().EqualTo(tree.cend()));
 		AssertThat(it, Equals(tree.find(expected)));
+		
+		for (t_key i(0); i < max_key; ++i)
+		{
+			auto const ref_it(ref_set.lower_bound(i));
+			auto const it(tree.lower_bound(i));
+			AssertThat(it, Is().Not().EqualTo(tree.cend()));
+			trait.compare(*it, *ref_it);
+		}
+		
+		AssertThat(tree.lower_bound(1 + max_key), Equals(tree.cend()));
 	});
 	
 	it("has working iterators", [&](){
@@ -155,6 +172,88 @@ void static_binary_tree_tests(t_vec vec, t_key lower, t_key expected) // Copy.
 }
 
 
+// Compare the (possibly vectorized) count with a linear scan. AVX2 only has signed comparison,
+// so some of the keys have the high bit set, and the sizes leave partial vectors at the end.
+template <typename t_key>
+void count_less_tests()
+{
+	it("counts the keys less than the given one", [](){
+		typedef sdsl::int_vector <std::numeric_limits <t_key>::digits> vector_type;
+		t_key const high(t_key(1) << (std::numeric_limits <t_key>::digits - 1));
+		asm_lsw::detail::static_binary_tree_count_less <t_key> count_less;
+		
+		for (std::size_t size(0); size <= 20; ++size)
+		{
+			vector_type keys(size, 0);
+			for (std::size_t i(0); i < size; ++i)
+				keys[i] = (i < size / 2 ? 0 : high) + 5 * i;
+			
+			std::vector <t_key> probes{0, t_key(high - 1), high, t_key(high + 1), std::numeric_limits <t_key>::max()};
+			for (std::size_t i(0); i < size; ++i)
+			{
+				t_key const key(keys[i]);
+				probes.push_back(key - 1);
+				probes.push_back(key);
+				probes.push_back(key + 1);
+			}
+			
+			for (auto const probe : probes)
+			{
+				std::size_t expected(0);
+				for (std::size_t i(0); i < size; ++i)
+					expected += (keys[i] < probe);
+				
+				AssertThat(count_less(keys, probe), Equals(expected));
+			}
+		}
+	});
+}
+
+
+// Check the trees near the size limit of the linear search with keys that have the high bit set.
+template <typename t_key, asm_lsw::static_binary_tree_layout t_layout>
+void linear_search_limit_tests()
+{
+	typedef asm_lsw::static_binary_tree <t_key, void, true, t_layout> tree_type;
+	std::size_t const limit(tree_type::s_linear_search_limit);
+	
+	for (std::size_t const size : {limit - 1, limit, limit + 1, 2 * limit + 1})
+	{
+		it(("finds the keys in a tree of " + std::to_string(size) + " keys").c_str(), [size](){
+			t_key const high(t_key(1) << (std::numeric_limits <t_key>::digits - 1));
+			
+			// Alternate between the low and the high keys so that the input is not sorted.
+			std::vector <t_key> vec(size);
+			for (std::size_t i(0); i < size; ++i)
+				vec[i] = (i % 2 ? high : 0) + 3 * (i / 2) + 1;
+			
+			std::set <t_key> const ref_set(vec.cbegin(), vec.cend());
+			tree_type const tree(vec);
+			AssertThat(tree.size(), Equals(size));
+			AssertThat(std::equal(tree.cbegin(), tree.cend(), ref_set.cbegin(), ref_set.cend()), Equals(true));
+			
+			for (auto const key : ref_set)
+			{
+				for (t_key const probe : {t_key(key - 1), key, t_key(key + 1)})
+				{
+					auto const ref_it(ref_set.lower_bound(probe));
+					auto const it(tree.lower_bound(probe));
+					if (ref_set.cend() == ref_it)
+						AssertThat(it, Equals(tree.cend()));
+					else
+					{
+						AssertThat(it, Is().Not().EqualTo(tree.cend()));
+						AssertThat(*it, Equals(*ref_it));
+					}
+					
+					AssertThat(tree.find(probe) == tree.cend(), Equals(0 == ref_set.count(probe)));
+				}
+			}
+		});
+	}
+}
+
+
 template <typename T>
 void fill_map_1(std::vector <std::pair <T, T>> &out_vec)
 {
@@ -226,6 +325,59 @@ go_bandit([](){
 	}
 	
 	{
+		sdsl::int_vector <0> vec(80, 0);
+		for (std::size_t i(0); i < vec.size(); ++i)
+			vec[i] = 3 * i;
+		
+		describe("static_binary_tree <uint32_t, void, true, veb>:", [&](){
+			static_binary_tree_tests <uint32_t, void, asm_lsw::static_binary_tree_layout::veb>(vec, 10, 12);
+		});
+		
+		describe("static_binary_tree <uint32_t, void, true, blocked>:", [&](){
+			static_binary_tree_tests <uint32_t, void, asm_lsw::static_binary_tree_layout::blocked>(vec, 10, 12);
+		});
+	}
+	
+	{
+		// More values than the linear search limit of uint8_t.
+		sdsl::int_vector <0> vec(200, 0);
+		for (std::size_t i(0); i < vec.size(); ++i)
+			vec[i] = (i < 11 ? i : 1 + i);
+		
+		describe("static_binary_tree <uint8_t, void, true, blocked>:", [&](){
+			static_binary_tree_tests <uint8_t, void, asm_lsw::static_binary_tree_layout::blocked>(vec, 11, 12);
+		});
+	}
+	
+	describe("static_binary_tree_count_less <uint8_t>:", [](){
+		count_less_tests <uint8_t>();
+	});
+	
+	describe("static_binary_tree_count_less <uint32_t>:", [](){
+		count_less_tests <uint32_t>();
+	});
+	
+	describe("static_binary_tree_count_less <uint64_t>:", [](){
+		count_less_tests <uint64_t>();
+	});
+	
+	describe("static_binary_tree <uint32_t, void, true> near the linear search limit:", [](){
+		linear_search_limit_tests <uint32_t, asm_lsw::static_binary_tree_layout::bfs>();
+	});
+	
+	describe("static_binary_tree <uint64_t, void, true, blocked> near the linear search limit:", [](){
+		linear_search_limit_tests <uint64_t, asm_lsw::static_binary_tree_layout::blocked>();
+	});
+	
+	{
+		{
+			describe("static_binary_tree <uint32_t, uint32_t, true, veb> (2):", [&](){
+				std::vector <std::pair <uint32_t, uint32_t>> vec;
+				fill_map_2(vec);
+				static_binary_tree_tests <uint32_t, uint32_t, asm_lsw::static_binary_tree_layout::veb>(vec, 9, 12);
+			});
+		}
+		
 		{
 			describe("static_binary_tree <uint32_t, uint32_t, true> (1):", [&](){
 				std::vector <std::pair <uint32_t, uint32_t>> vec;
@@ -25,6 +25,8 @@
 #include <boost/iterator/zip_iterator.hpp>
 #include <boost/range.hpp>
 #include <boost/range/irange.hpp>
+#include <set>
+#include <vector>
 
 using namespace bandit;
 
@@ -643,6 +645,53 @@ void common_as_type_tests()
 }
 
 
+template <typename t_trie, typename t_as_trie>
+void as_range_query_tests()
+{
+	typedef t_trie trie_type;
+	typedef t_as_trie ct_type;
+	typedef typename ct_type::key_type key_type;
+	
+	it("handles range queries", [](){
+		trie_type trie;
+		std::set <key_type> ref;
+		for (key_type i(0x10003); i < 0x10100; i += 7)
+		{
+			trie.insert(i);
+			ref.insert(i);
+		}
+		
+		std::unique_ptr <ct_type> ct(ct_type::construct(trie));
+		AssertThat(ct->offset(), Equals(0x10003));
+		
+		for (key_type lo(0xfff0); lo < 0x10110; lo += 5)
+		{
+			for (key_type hi(lo); hi < lo + 40; hi += 3)
+			{
+				auto const lo_it(ref.lower_bound(lo));
+				auto const hi_it(ref.upper_bound(hi));
+				auto const expected_count(std::distance(lo_it, hi_it));
+				
+				key_type first(0);
+				AssertThat(ct->range_exists(lo, hi), Equals(0 < expected_count));
+				AssertThat(ct->range_exists(lo, hi, first), Equals(0 < expected_count));
+				if (expected_count)
+					AssertThat(first, Equals(*lo_it));
+				
+				AssertThat(ct->count(lo, hi), Equals(expected_count));
+				
+				std::vector <key_type> keys;
+				ct->for_each_in_range(lo, hi, [&keys](key_type const key){ keys.push_back(key); });
+				AssertThat(std::equal(keys.cbegin(), keys.cend(), lo_it, hi_it), Equals(true));
+			}
+		}
+		
+		AssertThat(ct->range_exists(0x10100, 0x10000), Equals(false));
+		AssertThat(ct->count(0, std::numeric_limits <key_type>::max()), Equals(ref.size()));
+	});
+}
+
+
 template <typename t_trie, typename t_adaptor>
 void x_fast_any_tests()
 {
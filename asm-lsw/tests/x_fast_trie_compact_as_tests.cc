@@ -22,6 +22,7 @@ go_bandit([](){
 	// Compact X-fast tries (AS)
 	describe("compact AS trie:", [](){
 		common_as_type_tests <asm_lsw::x_fast_trie <uint32_t>, asm_lsw::x_fast_trie_compact_as <uint32_t, void, true>>();
+		as_range_query_tests <asm_lsw::x_fast_trie <uint32_t>, asm_lsw::x_fast_trie_compact_as <uint32_t, void, true>>();
 	});
 
 	describe("compact X-fast trie <uint8_t> (AS):", [](){
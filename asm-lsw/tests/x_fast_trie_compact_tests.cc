@@ -57,4 +57,31 @@ go_bandit([](){
 		common_map_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
 		compact_any_type_tests <trie_type, ct_type>();
 	});
+
+	describe("compact X-fast trie <uint8_t> with a top level table:", [](){
+		typedef asm_lsw::x_fast_trie <uint8_t> trie_type;
+		typedef asm_lsw::x_fast_trie_compact <uint8_t, void, true, 7> ct_type;
+		common_any_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		x_fast_any_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		common_set_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		compact_any_type_tests <trie_type, ct_type>();
+	});
+
+	describe("compact X-fast trie <uint32_t, uint32_t> with minimal perfect hashing:", [](){
+		typedef asm_lsw::x_fast_trie <uint32_t, uint32_t> trie_type;
+		typedef asm_lsw::x_fast_trie_compact <uint32_t, uint32_t, true, 0, true> ct_type;
+		common_any_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		x_fast_any_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		common_map_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		compact_any_type_tests <trie_type, ct_type>();
+	});
+
+	describe("compact X-fast trie <uint32_t, uint32_t> with a top level table:", [](){
+		typedef asm_lsw::x_fast_trie <uint32_t, uint32_t> trie_type;
+		typedef asm_lsw::x_fast_trie_compact <uint32_t, uint32_t, true, 8> ct_type;
+		common_any_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		x_fast_any_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		common_map_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		compact_any_type_tests <trie_type, ct_type>();
+	});
 });
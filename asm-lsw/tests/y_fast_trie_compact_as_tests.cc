@@ -22,6 +22,7 @@ go_bandit([](){
 	// Compact Y-fast tries (AS)
 	describe("compact AS trie:", [](){
 		common_as_type_tests <asm_lsw::y_fast_trie <uint32_t>, asm_lsw::y_fast_trie_compact_as <uint32_t>>();
+		as_range_query_tests <asm_lsw::y_fast_trie <uint32_t>, asm_lsw::y_fast_trie_compact_as <uint32_t>>();
 
 		it("can be constructed with a vector", [](){
 			typedef asm_lsw::y_fast_trie_compact_as <uint32_t, void, true> trie_type;
@@ -52,6 +53,37 @@ go_bandit([](){
 				AssertThat(it->second, Equals(kv.second));
 			}
 		});
+		
+		it("can find keys and values without iterators", [](){
+			typedef asm_lsw::y_fast_trie_compact_as <uint32_t, uint32_t, true> trie_type;
+			std::map <uint32_t, uint32_t> map{{0x10005, 8}, {0x10018, 21}, {0x10022, 3}, {0x10035, 7}, {0x10108, 99}};
+
+			std::unique_ptr <trie_type> trie_ptr(trie_type::construct(map, 0x10005, 0x10108));
+			AssertThat(trie_ptr->key_size(), Equals(2));
+			AssertThat(trie_ptr->contains(0x10022), Equals(true));
+			AssertThat(trie_ptr->contains(0x10023), Equals(false));
+			AssertThat(trie_ptr->contains(0x22), Equals(false));
+			AssertThat(trie_ptr->contains(0x20022), Equals(false));
+			
+			uint32_t key(0), value(0);
+			AssertThat(trie_ptr->find_predecessor(0x10022, key, value, true), Equals(true));
+			AssertThat(key, Equals(0x10022));
+			AssertThat(value, Equals(3));
+			AssertThat(trie_ptr->find_predecessor(0x10022, key, value), Equals(true));
+			AssertThat(key, Equals(0x10018));
+			AssertThat(value, Equals(21));
+			AssertThat(trie_ptr->find_predecessor(0x10005, key), Equals(false));
+			AssertThat(trie_ptr->find_predecessor(0x40000, key), Equals(true));
+			AssertThat(key, Equals(0x10108));
+			
+			AssertThat(trie_ptr->find_successor(0x10035, key, value), Equals(true));
+			AssertThat(key, Equals(0x10108));
+			AssertThat(value, Equals(99));
+			AssertThat(trie_ptr->find_successor(0x10, key), Equals(true));
+			AssertThat(key, Equals(0x10005));
+			AssertThat(trie_ptr->find_successor(0x10108, key), Equals(false));
+			AssertThat(trie_ptr->find_successor(0x40000, key), Equals(false));
+		});
 	});
 	
 	describe("compact Y-fast trie <uint8_t> (AS):", [](){
@@ -87,4 +119,11 @@ go_bandit([](){
 		common_any_type_tests <trie_type, compact_as_trie_adaptor <trie_type, ct_type>>();
 		common_map_type_tests <trie_type, compact_as_trie_adaptor <trie_type, ct_type>>();
 	});
+
+	describe("compact Y-fast trie <uint32_t, uint32_t> (AS) with a top level table:", [](){
+		typedef asm_lsw::y_fast_trie <uint32_t, uint32_t> trie_type;
+		typedef asm_lsw::y_fast_trie_compact_as <uint32_t, uint32_t, true, 8> ct_type;
+		common_any_type_tests <trie_type, compact_as_trie_adaptor <trie_type, ct_type>>();
+		common_map_type_tests <trie_type, compact_as_trie_adaptor <trie_type, ct_type>>();
+	});
 });
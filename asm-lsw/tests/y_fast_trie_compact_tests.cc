@@ -51,4 +51,20 @@ go_bandit([](){
 		common_any_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
 		common_map_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
 	});
+
+	describe("compact Y-fast trie <uint32_t> with a top level table:", [](){
+		typedef asm_lsw::y_fast_trie <uint32_t> trie_type;
+		typedef asm_lsw::y_fast_trie_compact <uint32_t, void, true, 8> ct_type;
+		common_any_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		common_set_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		compact_set_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		y_fast_set_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+	});
+
+	describe("compact Y-fast trie <uint32_t, uint32_t> with van Emde Boas subtrees:", [](){
+		typedef asm_lsw::y_fast_trie <uint32_t, uint32_t> trie_type;
+		typedef asm_lsw::y_fast_trie_compact <uint32_t, uint32_t, true, 0, asm_lsw::static_binary_tree_layout::veb> ct_type;
+		common_any_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+		common_map_type_tests <trie_type, compact_trie_adaptor <trie_type, ct_type>>();
+	});
 });